@@ -0,0 +1,406 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+// throughput benchmarks for parsing, dumping and accessing values
+//
+// usage: bench [--sweep] [--filter <text>] [--baseline <file>] [--save <file>] [--threshold <percent>]
+//
+// every workload runs over each corpus and reports MB/s of JSON text, nanoseconds
+// per value and heap allocations per run. the MessagePack and CBOR workloads are
+// measured against the JSON text too so that all formats compare directly, and
+// the encoded size of each corpus is printed at the end. results are compared against the baseline,
+// bench/baseline.json if it exists, and any workload that got slower by more than
+// the threshold is flagged and makes the program exit with a failure. --sweep replaces
+// the corpora with generated documents that vary one generator setting at a time.
+
+#include <jsonpp/value.hpp>
+#include <jsonpp/parser.hpp>
+#include <jsonpp/generator.hpp>
+#include <jsonpp/msgpack.hpp>
+#include <jsonpp/cbor.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+
+// the number of calls to operator new so far, see allocations.cpp
+std::size_t allocation_count() JSONPP_NOEXCEPT;
+
+namespace {
+struct corpus {
+    std::string name;
+    std::string text;
+    json::value doc;
+    std::size_t values;
+    std::string msgpack;
+    std::string cbor;
+};
+
+struct result {
+    double mb_per_s;
+    double ns_per_value;
+    double allocations;
+};
+
+std::size_t count_values(const json::value& v) {
+    std::size_t result = 1;
+    if(v.is<json::array>()) {
+        for(auto&& elem : v.get<json::array>()) {
+            result += count_values(elem);
+        }
+    }
+    else if(v.is<json::object>()) {
+        for(auto&& member : v.get<json::object>()) {
+            result += count_values(member.second);
+        }
+    }
+    return result;
+}
+
+// reads every value the way application code would, looking members up by key
+double access(const json::value& v) {
+    if(v.is<json::array>()) {
+        double total = 0;
+        auto&& arr = v.get<json::array>();
+        for(std::size_t i = 0; i < arr.size(); ++i) {
+            total += access(v[i]);
+        }
+        return total;
+    }
+
+    if(v.is<json::object>()) {
+        double total = 0;
+        for(auto&& member : v.get<json::object>()) {
+            total += access(v[member.first]);
+        }
+        return total;
+    }
+
+    if(v.is<std::string>()) {
+        return static_cast<double>(v.get<std::string>().size());
+    }
+    return v.as<double>(0.0) + (v.as<bool>(false) ? 1 : 0);
+}
+
+// 20000 numbers mixing small integers, large integers and fractions
+std::string numeric_corpus() {
+    std::ostringstream out;
+    unsigned seed = 1;
+    out << '[';
+    for(int i = 0; i < 20000; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        if(i != 0) {
+            out << ',';
+        }
+        switch(i % 4) {
+        case 0:
+            out << (seed % 1000);
+            break;
+        case 1:
+            out << '-' << seed;
+            break;
+        case 2:
+            out << (seed % 100000) / 1000.0;
+            break;
+        default:
+            out << (seed % 1000) << ".25e" << static_cast<int>(seed % 40) - 20;
+            break;
+        }
+    }
+    out << ']';
+    return out.str();
+}
+
+// 5000 strings of varying length, some with escapes and multi-byte characters
+std::string string_corpus() {
+    std::ostringstream out;
+    unsigned seed = 2;
+    out << '[';
+    for(int i = 0; i < 5000; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        if(i != 0) {
+            out << ',';
+        }
+        out << '"';
+        for(unsigned j = 0, n = 8 + (seed >> 16) % 64; j < n; ++j) {
+            switch((j + i) % 23) {
+            case 0:
+                out << "\\n";
+                break;
+            case 7:
+                out << "\\\"";
+                break;
+            case 13:
+                out << "\\u00e9";
+                break;
+            case 19:
+                out << "\xe3\x81\x82";
+                break;
+            default:
+                out << static_cast<char>('a' + (j * 7 + i) % 26);
+                break;
+            }
+        }
+        out << '"';
+    }
+    out << ']';
+    return out.str();
+}
+
+// 200 documents of objects and arrays nested 100 levels deep
+std::string nested_corpus() {
+    std::string out = "[";
+    for(int i = 0; i < 200; ++i) {
+        if(i != 0) {
+            out += ',';
+        }
+        for(int depth = 0; depth < 100; ++depth) {
+            out += depth % 2 == 0 ? "{\"level\":" + std::to_string(depth) + ",\"next\":" : "[true,";
+        }
+        out += "null";
+        for(int depth = 100; depth-- != 0;) {
+            out += depth % 2 == 0 ? '}' : ']';
+        }
+    }
+    out += ']';
+    return out;
+}
+
+corpus make_corpus(const std::string& name, std::string text) {
+    corpus result{ name, std::move(text), {}, 0, {}, {} };
+    json::parse(result.text, result.doc);
+    result.values = count_values(result.doc);
+    result.msgpack = json::msgpack::dump_string(result.doc);
+    result.cbor = json::cbor::dump_string(result.doc);
+    return result;
+}
+
+// one megabyte documents that each differ from the generator defaults in one setting
+std::vector<corpus> sweep_corpora() {
+    json::generator_options defaults;
+    defaults.size = 1 << 20;
+
+    std::vector<corpus> result;
+    auto add = [&result](const std::string& name, const json::generator_options& opt) {
+        result.push_back(make_corpus("generated/" + name, json::generate_string(opt)));
+    };
+
+    for(unsigned depth : { 1, 2, 4, 8 }) {
+        auto opt = defaults;
+        opt.depth = depth;
+        add("depth=" + std::to_string(depth), opt);
+    }
+
+    for(unsigned width : { 2, 32 }) {
+        auto opt = defaults;
+        opt.width = width;
+        opt.length = width;
+        add("width=" + std::to_string(width), opt);
+    }
+
+    for(unsigned length : { 4, 64, 256 }) {
+        auto opt = defaults;
+        opt.string_length = length;
+        opt.string_ratio = 1;
+        add("string-length=" + std::to_string(length), opt);
+    }
+
+    for(int percent : { 0, 25 }) {
+        auto opt = defaults;
+        opt.escape_ratio = percent / 100.0;
+        opt.string_ratio = 1;
+        add("escapes=" + std::to_string(percent) + "%", opt);
+    }
+
+    const char* names[] = { "small", "large", "decimal", "exponent" };
+    for(int i = 0; i < json::generator_options::mixed; ++i) {
+        auto opt = defaults;
+        opt.numbers = static_cast<json::generator_options::number_distribution>(i);
+        opt.string_ratio = 0;
+        add(std::string("numbers=") + names[i], opt);
+    }
+    return result;
+}
+
+// runs f in batches until enough time has passed and keeps the fastest batch
+result measure(const corpus& c, const std::function<void()>& f) {
+    using clock = std::chrono::steady_clock;
+    std::size_t iterations = 1;
+    double best = 0;
+    std::size_t allocated = 0;
+    auto deadline = clock::now() + std::chrono::milliseconds(500);
+    while(true) {
+        auto before = allocation_count();
+        auto start = clock::now();
+        for(std::size_t i = 0; i < iterations; ++i) {
+            f();
+        }
+        auto end = clock::now();
+        allocated = allocation_count() - before;
+
+        double seconds = std::chrono::duration<double>(end - start).count() / iterations;
+        if(best == 0 || seconds < best) {
+            best = seconds;
+        }
+
+        if(end >= deadline) {
+            break;
+        }
+
+        if(seconds * iterations < 0.05) {
+            iterations *= 2;
+        }
+    }
+
+    return result{ c.text.size() / best / 1e6, best * 1e9 / c.values, static_cast<double>(allocated) / iterations };
+}
+
+const char* argument(int& i, int argc, char** argv) {
+    if(i + 1 >= argc) {
+        std::cerr << "missing argument to " << argv[i] << '\n';
+        std::exit(EXIT_FAILURE);
+    }
+    return argv[++i];
+}
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    std::string filter;
+    bool sweep = false;
+    std::string baseline_file = "bench/baseline.json";
+    std::string save_file;
+    double threshold = 10;
+    for(int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if(arg == "--sweep") {
+            sweep = true;
+        }
+        else if(arg == "--filter") {
+            filter = argument(i, argc, argv);
+        }
+        else if(arg == "--baseline") {
+            baseline_file = argument(i, argc, argv);
+        }
+        else if(arg == "--save") {
+            save_file = argument(i, argc, argv);
+        }
+        else if(arg == "--threshold") {
+            threshold = std::atof(argument(i, argc, argv));
+        }
+        else {
+            std::cerr << "usage: " << argv[0] << " [--sweep] [--filter <text>] [--baseline <file>] [--save <file>] [--threshold <percent>]\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    json::value baseline;
+    std::ifstream baseline_in(baseline_file);
+    if(baseline_in) {
+        json::parse(baseline_in, baseline);
+    }
+
+    std::vector<corpus> corpora;
+    if(sweep) {
+        corpora = sweep_corpora();
+    }
+    else {
+        std::ifstream twitter("tests/real/twitter.json");
+        if(!twitter) {
+            std::cerr << "cannot open tests/real/twitter.json, run the benchmarks from the repository root\n";
+            return EXIT_FAILURE;
+        }
+
+        std::ostringstream ss;
+        ss << twitter.rdbuf();
+
+        corpora.push_back(make_corpus("twitter", ss.str()));
+        corpora.push_back(make_corpus("numeric", numeric_corpus()));
+        corpora.push_back(make_corpus("strings", string_corpus()));
+        corpora.push_back(make_corpus("nested", nested_corpus()));
+    }
+
+    json::object results;
+    std::size_t regressions = 0;
+    double sink = 0;
+    std::printf("%-40s %10s %12s %12s %10s\n", "benchmark", "MB/s", "ns/value", "allocs/run", "change");
+    for(auto&& c : corpora) {
+        std::vector<std::pair<std::string, std::function<void()>>> workloads = {
+            { "parse", [&c] { json::value v; json::parse(c.text, v); } },
+            { "parse-lazy", [&c] { json::value v; json::parse(c.text, v, json::parse_options::lazy_numbers); } },
+            { "dump", [&c, &sink] { sink += json::dump_string(c.doc).size(); } },
+            { "dump-minify", [&c, &sink] { sink += json::dump_string(c.doc, json::format_options(0, json::format_options::minify)).size(); } },
+            { "access", [&c, &sink] { sink += access(c.doc); } },
+            { "msgpack-encode", [&c, &sink] { sink += json::msgpack::dump_string(c.doc).size(); } },
+            { "msgpack-decode", [&c] { json::value v; json::msgpack::parse(c.msgpack, v); } },
+            { "cbor-encode", [&c, &sink] { sink += json::cbor::dump_string(c.doc).size(); } },
+            { "cbor-decode", [&c] { json::value v; json::cbor::parse(c.cbor, v); } }
+        };
+
+        for(auto&& workload : workloads) {
+            auto name = c.name + '/' + workload.first;
+            if(name.find(filter) == std::string::npos) {
+                continue;
+            }
+
+            auto r = measure(c, workload.second);
+            results[name] = json::object{ { "mb_per_s", r.mb_per_s }, { "ns_per_value", r.ns_per_value }, { "allocations", r.allocations } };
+
+            std::string change;
+            auto previous = baseline.find(name);
+            if(previous != nullptr && previous->is<json::object>()) {
+                double old = (*previous)["mb_per_s"].as<double>(0.0);
+                if(old > 0) {
+                    double percent = (r.mb_per_s - old) / old * 100;
+                    char buffer[32];
+                    std::snprintf(buffer, sizeof(buffer), "%+.1f%%", percent);
+                    change = buffer;
+                    if(-percent > threshold) {
+                        change += " REGRESSION";
+                        ++regressions;
+                    }
+                }
+            }
+
+            std::printf("%-40s %10.1f %12.2f %12.0f %10s\n", name.c_str(), r.mb_per_s, r.ns_per_value, r.allocations, change.c_str());
+        }
+    }
+
+    std::printf("\n%-40s %10s %12s %12s\n", "encoded size", "json", "msgpack", "cbor");
+    for(auto&& c : corpora) {
+        std::printf("%-40s %10zu %12zu %12zu\n", c.name.c_str(), c.text.size(), c.msgpack.size(), c.cbor.size());
+    }
+
+    if(!save_file.empty()) {
+        std::ofstream out(save_file);
+        dump(out, json::value(std::move(results)));
+        out << '\n';
+    }
+
+    if(regressions != 0) {
+        std::printf("%zu benchmark(s) regressed by more than %.1f%% against %s\n", regressions, threshold, baseline_file.c_str());
+        return EXIT_FAILURE;
+    }
+    return sink < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
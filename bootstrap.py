@@ -18,7 +18,40 @@ project = senpai.Project(name='jsonpp', compiler=senpai.compiler(args.cxx), buil
 project.includes = ['.', 'jsonpp']
 project.dependencies = [os.path.join('Catch', 'single_include')]
 S = senpai.Executable(name='tests', target='build', run='run')
-S.files = senpai.files_from('tests', '*.cpp')
+S.files = [f for f in senpai.files_from('tests', '*.cpp') if os.path.dirname(f) == 'tests']
+
+# copy on write changes the layout of json::value so it gets its own executable
+cow = senpai.Executable(name='tests_cow', target='build_cow', run='run_cow', objdir=os.path.join('obj', 'cow'))
+cow.files = [os.path.join('tests', 'runner.cpp')] + senpai.files_from(os.path.join('tests', 'cow'), '*.cpp')
+cow.defines = ['JSONPP_COPY_ON_WRITE']
+
+# so does collecting statistics, which changes the inline functions of the parser and dump
+stats = senpai.Executable(name='tests_stats', target='build_stats', run='run_stats', objdir=os.path.join('obj', 'stats'))
+stats.files = [os.path.join('tests', 'runner.cpp')] + senpai.files_from(os.path.join('tests', 'stats'), '*.cpp')
+stats.defines = ['JSONPP_STATS']
+
+# and so does memoizing hashes, which adds a member to every payload
+memo = senpai.Executable(name='tests_memo', target='build_memo', run='run_memo', objdir=os.path.join('obj', 'memo'))
+memo.files = [os.path.join('tests', 'runner.cpp')] + senpai.files_from(os.path.join('tests', 'memo'), '*.cpp')
+memo.defines = ['JSONPP_MEMOIZE_HASH']
+
+# the compiled mode, where the common parse and dump paths live in libjsonpp.a
+library = senpai.Library(name='jsonpp', target='build_library', objdir=os.path.join('obj', 'library'))
+library.files = [os.path.join('src', 'jsonpp.cpp')]
+library.defines = ['JSONPP_SEPARATE_COMPILATION']
+
+separate = senpai.Executable(name='tests_separate', target='build_separate', run='run_separate', objdir=os.path.join('obj', 'separate'))
+separate.files = [os.path.join('tests', 'runner.cpp')] + senpai.files_from(os.path.join('tests', 'separate'), '*.cpp')
+separate.defines = ['JSONPP_SEPARATE_COMPILATION']
+separate.link_with = [library]
+
+# throughput benchmarks, run from the repository root so the corpora are found
+bench = senpai.Executable(name='bench', target='build_bench', run='run_bench', objdir=os.path.join('obj', 'bench'))
+bench.files = senpai.files_from('bench', '*.cpp')
+
+# writes synthetic documents, see jsonpp/generator.hpp
+generate = senpai.Executable(name='generate', target='build_generate', objdir=os.path.join('obj', 'tools'))
+generate.files = [os.path.join('tools', 'generate.cpp')]
 
 def warning(string):
     if not args.quiet:
@@ -28,7 +61,7 @@ def warning(string):
 if 'g++' not in args.cxx:
     warning('compiler not explicitly supported: {}'.format(args.cxx))
 
-cxxflags = ['-Wall', '-Wextra', '-pedantic', '-std=c++11', '-Wno-switch']
+cxxflags = ['-Wall', '-Wextra', '-pedantic', '-std=c++11', '-Wno-switch', '-pthread']
 
 if args.debug:
     cxxflags.extend(['-g', '-O0', '-DDEBUG'])
@@ -46,4 +79,26 @@ if args.use_libcxx:
 
 project.flags = cxxflags
 project.add_executable(S)
-project.dump(open('build.ninja', 'w'))
+project.add_executable(cow)
+project.add_executable(stats)
+project.add_executable(memo)
+project.add_library(library)
+project.add_executable(separate)
+project.add_executable(bench)
+project.add_executable(generate)
+
+with open('build.ninja', 'w') as f:
+    project.dump(f)
+
+    # rebuilds the tests_separate sources without optimisations so that inlining hides nothing
+    # and fails if they contain code that libjsonpp.a already compiles
+    ninja = senpai.NinjaWriter(f)
+    ninja.rule('check_symbols', command='$cxx -c $cxxflags -O0 $includes $depends -D JSONPP_SEPARATE_COMPILATION $in -o $out && (python {} $out || (rm -f $out; exit 1))'.format(os.path.join('tests', 'separate', 'symbols.py')),
+               description='Checking the symbols of $in')
+    checked = []
+    for filename in separate.files:
+        if os.path.dirname(filename) == os.path.join('tests', 'separate'):
+            obj = os.path.join('obj', 'symbols', project.compiler.object_file(filename))
+            ninja.build(obj, 'check_symbols', inputs=filename)
+            checked.append(obj)
+    ninja.build('check_separate', 'phony', inputs=checked)
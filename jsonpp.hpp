@@ -24,5 +24,14 @@
 
 #include "jsonpp/value.hpp"
 #include "jsonpp/parser.hpp"
+#include "jsonpp/pointer.hpp"
+#include "jsonpp/writer.hpp"
+#include "jsonpp/msgpack.hpp"
+#include "jsonpp/cbor.hpp"
+#include "jsonpp/snapshot.hpp"
+#include "jsonpp/document.hpp"
+#include "jsonpp/patch.hpp"
+#include "jsonpp/cache.hpp"
+#include "jsonpp/sequence.hpp"
 
 #endif // JSONPP_HPP
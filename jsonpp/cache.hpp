@@ -0,0 +1,129 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef JSONPP_CACHE_HPP
+#define JSONPP_CACHE_HPP
+
+#include "parser.hpp"
+#include "document.hpp"
+#include "detail/hash.hpp"
+#include <list>
+#include <unordered_map>
+
+namespace json {
+// keeps the documents parsed from recently seen inputs so that parsing the same
+// bytes again returns the shared document instead of running the parser
+// entries are found by a hash of the input and confirmed by comparing the bytes,
+// the least recently used entry is dropped once the capacity is reached
+class parse_cache {
+private:
+    struct entry {
+        std::uint64_t key;
+        std::string text;
+        document_ref doc;
+    };
+
+    using list_type = std::list<entry>;
+
+    std::size_t limit;
+    parse_options opt;
+    list_type entries; // most recently used first
+    std::unordered_map<std::uint64_t, list_type::iterator> index;
+    mutable std::mutex mutex;
+
+    // returns the cached document for str and marks it as recently used
+    document_ref find(std::uint64_t key, const std::string& str) {
+        auto it = index.find(key);
+        if(it == index.end() || it->second->text != str) {
+            return document_ref();
+        }
+        entries.splice(entries.begin(), entries, it->second);
+        return it->second->doc;
+    }
+public:
+    explicit parse_cache(std::size_t capacity, parse_options opt = {}): limit(capacity), opt(opt) {
+        assert(capacity != 0);
+    }
+
+    parse_cache(const parse_cache&) = delete;
+    parse_cache& operator=(const parse_cache&) = delete;
+
+    // returns the document parsed from str, parsing it only if it is not cached
+    // threads parsing the same new input at the same time may both run the parser,
+    // in which case all of them get the document that was cached first
+    document_ref parse(const std::string& str) {
+        auto key = detail::hash_bytes(str.data(), str.size());
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto doc = find(key, str);
+            if(doc) {
+                return doc;
+            }
+        }
+
+        // parse without holding the lock so hits are not held up by a large input
+        value v;
+        parser js(str.c_str(), opt);
+        js.parse(v);
+        document_ref doc(new detail::document_node(std::move(v)));
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto cached = find(key, str);
+        if(cached) {
+            return cached;
+        }
+
+        auto it = index.find(key);
+        if(it != index.end()) {
+            // a different input with the same hash, the newer one replaces it
+            entries.erase(it->second);
+            index.erase(it);
+        }
+        else if(entries.size() == limit) {
+            index.erase(entries.back().key);
+            entries.pop_back();
+        }
+
+        entries.push_front(entry{ key, str, doc });
+        index.emplace(key, entries.begin());
+        return doc;
+    }
+
+    std::size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return entries.size();
+    }
+
+    std::size_t capacity() const JSONPP_NOEXCEPT {
+        return limit;
+    }
+
+    // drops every entry, documents already returned stay alive while referenced
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex);
+        index.clear();
+        entries.clear();
+    }
+};
+} // json
+
+#endif // JSONPP_CACHE_HPP
@@ -0,0 +1,416 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef JSONPP_CBOR_HPP
+#define JSONPP_CBOR_HPP
+
+#include "detail/binary.hpp"
+#include "sink.hpp"
+#include <vector>
+#include <cassert>
+
+namespace json {
+namespace detail {
+namespace cbor_type {
+enum : unsigned {
+    positive, negative, bytes, text, array, object, tag, simple
+};
+} // cbor_type
+
+// writes the initial byte of a data item and its argument in the fewest bytes
+template<typename OStream>
+inline void write_cbor_head(OStream& out, unsigned major, std::uint64_t n) {
+    major <<= 5;
+    if(n < 24) {
+        write_byte(out, major | static_cast<unsigned>(n));
+    }
+    else if(n <= 0xFF) {
+        write_byte(out, major | 24);
+        write_big_endian(out, n, 1);
+    }
+    else if(n <= 0xFFFF) {
+        write_byte(out, major | 25);
+        write_big_endian(out, n, 2);
+    }
+    else if(n <= 0xFFFFFFFF) {
+        write_byte(out, major | 26);
+        write_big_endian(out, n, 4);
+    }
+    else {
+        write_byte(out, major | 27);
+        write_big_endian(out, n, 8);
+    }
+}
+
+template<typename OStream>
+inline void write_cbor_string(OStream& out, const std::string& str) {
+    write_cbor_head(out, cbor_type::text, str.size());
+    out.write(str.data(), str.size());
+}
+
+template<typename OStream>
+inline void write_cbor(OStream& out, const value& v) {
+    if(v.is<null>()) {
+        write_byte(out, 0xf6);
+    }
+    else if(v.is<bool>()) {
+        write_byte(out, v.as<bool>() ? 0xf5 : 0xf4);
+    }
+    else if(v.is<double>()) {
+        auto n = classify_number(v);
+        if(n.kind == binary_number::floating) {
+            write_float(out, n.number, 0xfa, 0xfb);
+        }
+        else {
+            // the negative argument is -(n + 1) in CBOR too
+            write_cbor_head(out, n.kind == binary_number::positive ? cbor_type::positive : cbor_type::negative, n.magnitude);
+        }
+    }
+    else if(v.is<std::string>()) {
+        write_cbor_string(out, v.get<std::string>());
+    }
+    else if(v.is<array>()) {
+        auto&& arr = v.get<array>();
+        write_cbor_head(out, cbor_type::array, arr.size());
+        for(auto&& elem : arr) {
+            write_cbor(out, elem);
+        }
+    }
+    else if(v.is<object>()) {
+        auto&& obj = v.get<object>();
+        write_cbor_head(out, cbor_type::object, obj.size());
+        for(auto&& member : obj) {
+            write_cbor_string(out, member.first);
+            write_cbor(out, member.second);
+        }
+    }
+}
+
+inline double half_to_double(unsigned half) {
+    unsigned exponent = (half >> 10) & 0x1F;
+    unsigned mantissa = half & 0x3FF;
+    double result;
+    if(exponent == 0) {
+        result = std::ldexp(mantissa, -24);
+    }
+    else if(exponent != 31) {
+        result = std::ldexp(mantissa + 1024, static_cast<int>(exponent) - 25);
+    }
+    else if(mantissa == 0) {
+        result = std::numeric_limits<double>::infinity();
+    }
+    else {
+        result = std::numeric_limits<double>::quiet_NaN();
+    }
+    return (half & 0x8000) != 0 ? -result : result;
+}
+
+// reads the argument of an initial byte, returns false for an indefinite length
+inline bool read_cbor_argument(byte_reader& in, unsigned info, std::uint64_t& n) {
+    if(info < 24) {
+        n = info;
+    }
+    else if(info < 28) {
+        n = in.big_endian(std::size_t(1) << (info - 24));
+    }
+    else if(info == 31) {
+        return false;
+    }
+    else {
+        in.fail("reserved CBOR additional information");
+    }
+    return true;
+}
+
+inline bool is_cbor_break(byte_reader& in) {
+    if(in.peek() == 0xff) {
+        in.byte();
+        return true;
+    }
+    return false;
+}
+
+// reads the rest of a byte or text string whose initial byte was already read
+inline void read_cbor_string(byte_reader& in, unsigned major, unsigned info, std::string& str) {
+    std::uint64_t size = 0;
+    if(read_cbor_argument(in, info, size)) {
+        in.append(str, size);
+        return;
+    }
+
+    // indefinite strings are a series of definite chunks of the same type
+    while(!is_cbor_break(in)) {
+        unsigned initial = in.byte();
+        if((initial >> 5) != major || !read_cbor_argument(in, initial & 0x1F, size)) {
+            in.fail("invalid chunk in indefinite length string");
+        }
+        in.append(str, size);
+    }
+}
+
+inline void read_cbor(byte_reader& in, value& v) {
+    unsigned initial = in.byte();
+    unsigned major = initial >> 5;
+    unsigned info = initial & 0x1F;
+    std::uint64_t n = 0;
+
+    // tags only add meaning to the item that follows so they are dropped
+    // they are skipped in a loop since a chain of them would otherwise recurse without limit
+    while(major == cbor_type::tag) {
+        if(!read_cbor_argument(in, info, n)) {
+            in.fail("tags cannot have an indefinite length");
+        }
+        initial = in.byte();
+        major = initial >> 5;
+        info = initial & 0x1F;
+    }
+
+    switch(major) {
+    case cbor_type::positive:
+    case cbor_type::negative:
+        if(!read_cbor_argument(in, info, n)) {
+            in.fail("integers cannot have an indefinite length");
+        }
+        v = major == cbor_type::positive ? integer_value(n) : negative_integer_value(n);
+        break;
+    case cbor_type::bytes:
+    case cbor_type::text: {
+        // byte strings are read as strings since JSON has nothing closer
+        std::string str;
+        read_cbor_string(in, major, info, str);
+        v = std::move(str);
+        break;
+    }
+    case cbor_type::array: {
+        in.enter();
+        array arr;
+        if(read_cbor_argument(in, info, n)) {
+            arr.resize(in.count(n));
+            for(auto&& elem : arr) {
+                read_cbor(in, elem);
+            }
+        }
+        else {
+            while(!is_cbor_break(in)) {
+                arr.emplace_back();
+                read_cbor(in, arr.back());
+            }
+        }
+        in.leave();
+        v = std::move(arr);
+        break;
+    }
+    case cbor_type::object: {
+        in.enter();
+        object obj;
+        std::string key;
+        bool definite = read_cbor_argument(in, info, n);
+        std::size_t count = definite ? in.count(n) : 0;
+        while(definite ? count-- != 0 : !is_cbor_break(in)) {
+            unsigned key_initial = in.byte();
+            unsigned key_major = key_initial >> 5;
+            if(key_major != cbor_type::text && key_major != cbor_type::bytes) {
+                in.fail("object keys must be strings");
+            }
+            key.clear();
+            read_cbor_string(in, key_major, key_initial & 0x1F, key);
+            read_cbor(in, obj[key]);
+        }
+        in.leave();
+        v = std::move(obj);
+        break;
+    }
+    default:
+        switch(info) {
+        case 20:
+            v = false;
+            break;
+        case 21:
+            v = true;
+            break;
+        case 22:
+        case 23: // undefined
+            v = nullptr;
+            break;
+        case 25:
+            v = half_to_double(static_cast<unsigned>(in.big_endian(2)));
+            break;
+        case 26:
+            v = static_cast<double>(bits_to_float(static_cast<std::uint32_t>(in.big_endian(4))));
+            break;
+        case 27:
+            v = bits_to_double(in.big_endian(8));
+            break;
+        default:
+            in.fail("unsupported CBOR simple value");
+        }
+    }
+}
+} // detail
+
+namespace cbor {
+// encodes a value as CBOR into a sink
+template<typename OStream>
+inline OStream& dump(OStream& out, const value& v) {
+    detail::write_cbor(out, v);
+    return out;
+}
+
+inline std::string dump_string(const value& v) {
+    string_sink out;
+    detail::write_cbor(out, v);
+    return std::move(out.str());
+}
+
+inline void parse(const char* data, std::size_t size, value& v, std::size_t max_depth = detail::default_binary_depth) {
+    detail::byte_reader in(data, size, max_depth);
+    detail::read_cbor(in, v);
+    if(!in.done()) {
+        in.fail("unexpected data after the value");
+    }
+}
+
+inline void parse(const std::string& data, value& v, std::size_t max_depth = detail::default_binary_depth) {
+    parse(data.data(), data.size(), v, max_depth);
+}
+
+// writes CBOR incrementally to a sink without building a value first
+// arrays and objects begun without a size have an indefinite length and are closed by a break,
+// those begun with one must get exactly that many elements
+template<typename OStream>
+class writer {
+private:
+    struct frame {
+        bool object;
+        bool definite;
+        std::size_t remaining; // the values still to be written when definite, keys are not counted
+    };
+
+    OStream& out;
+    std::vector<frame> frames;
+    bool has_key = false;
+    bool has_root = false;
+
+    void prepare_value() {
+        if(frames.empty()) {
+            assert(!has_root && "only a single root value can be written");
+            has_root = true;
+            return;
+        }
+
+        auto&& top = frames.back();
+        assert((!top.definite || top.remaining != 0) && "more elements than the size that was begun");
+        if(top.object) {
+            assert(has_key && "object members must begin with a key");
+            has_key = false;
+        }
+        if(top.definite) {
+            --top.remaining;
+        }
+    }
+
+    void begin(bool object) {
+        prepare_value();
+        detail::write_byte(out, ((object ? detail::cbor_type::object : detail::cbor_type::array) << 5) | 31);
+        frames.push_back({ object, false, 0 });
+    }
+
+    void begin(bool object, std::size_t size) {
+        prepare_value();
+        detail::write_cbor_head(out, object ? detail::cbor_type::object : detail::cbor_type::array, size);
+        frames.push_back({ object, true, size });
+    }
+
+    void end(bool object) {
+        assert(!frames.empty() && frames.back().object == object && "mismatched end of array or object");
+        assert(!has_key && "object key has no value");
+        assert(frames.back().remaining == 0 && "fewer elements than the size that was begun");
+        if(!frames.back().definite) {
+            detail::write_byte(out, 0xff);
+        }
+        frames.pop_back();
+    }
+public:
+    writer(OStream& out): out(out) {}
+
+    writer& begin_object() {
+        begin(true);
+        return *this;
+    }
+
+    writer& begin_object(std::size_t size) {
+        begin(true, size);
+        return *this;
+    }
+
+    writer& end_object() {
+        end(true);
+        return *this;
+    }
+
+    writer& begin_array() {
+        begin(false);
+        return *this;
+    }
+
+    writer& begin_array(std::size_t size) {
+        begin(false, size);
+        return *this;
+    }
+
+    writer& end_array() {
+        end(false);
+        return *this;
+    }
+
+    writer& key(const std::string& str) {
+        assert(!frames.empty() && frames.back().object && "keys can only be written inside objects");
+        assert(!has_key && "object key has no value");
+        detail::write_cbor_string(out, str);
+        has_key = true;
+        return *this;
+    }
+
+    // writes anything that converts to json::value
+    writer& value(const json::value& v) {
+        prepare_value();
+        detail::write_cbor(out, v);
+        return *this;
+    }
+
+    // whether every array and object that was begun has been ended
+    bool complete() const JSONPP_NOEXCEPT {
+        return has_root && frames.empty();
+    }
+
+    std::size_t depth() const JSONPP_NOEXCEPT {
+        return frames.size();
+    }
+};
+
+template<typename OStream>
+inline writer<OStream> make_writer(OStream& out) {
+    return { out };
+}
+} // cbor
+} // json
+
+#endif // JSONPP_CBOR_HPP
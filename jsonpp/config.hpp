@@ -36,4 +36,37 @@
 #include <ciso646>
 #endif
 
+// SIMD is used to scan strings unless JSONPP_NO_SIMD is defined
+#if !defined(JSONPP_NO_SIMD)
+#if defined(__AVX2__)
+#define JSONPP_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JSONPP_SSE2 1
+#endif
+#endif
+
+// JSONPP_SEPARATE_COMPILATION moves the common parse and dump paths out of every translation
+// unit and into the one that defines JSONPP_SOURCE, which is src/jsonpp.cpp in the library build
+#if defined(JSONPP_SOURCE) && !defined(JSONPP_SEPARATE_COMPILATION)
+#define JSONPP_SEPARATE_COMPILATION
+#endif
+
+#if defined(JSONPP_SEPARATE_COMPILATION)
+#define JSONPP_DECL
+#else
+#define JSONPP_DECL inline
+#endif
+
+#if defined(JSONPP_SOURCE)
+#define JSONPP_EXTERN
+#else
+#define JSONPP_EXTERN extern
+#endif
+
+// whether the definitions of JSONPP_DECL functions are part of this translation unit
+#if !defined(JSONPP_SEPARATE_COMPILATION) || defined(JSONPP_SOURCE)
+#define JSONPP_DEFINITIONS 1
+#endif
+
 #endif // JSONPP_CONFIG_HPP
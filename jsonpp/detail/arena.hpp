@@ -0,0 +1,198 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef JSONPP_DETAIL_ARENA_HPP
+#define JSONPP_DETAIL_ARENA_HPP
+
+#include "../config.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <new>
+
+namespace json {
+namespace detail {
+class number_arena;
+
+// the digits of a lazily parsed number, they follow it in memory and are null terminated
+struct arena_digits {
+    number_arena* arena;
+    std::size_t size;
+
+    const char* data() const JSONPP_NOEXCEPT {
+        return reinterpret_cast<const char*>(this + 1);
+    }
+};
+
+// the digits of every number kept by one parse with parse_options::lazy_numbers,
+// stored in blocks instead of one allocation per number
+// each number holds a reference to the arena and the last one to go frees it,
+// so a number that outlives its document keeps the digits of the whole document
+class number_arena {
+private:
+    struct block {
+        block* next;
+        std::size_t capacity;
+        std::size_t used;
+
+        char* data() JSONPP_NOEXCEPT {
+            return reinterpret_cast<char*>(this + 1);
+        }
+    };
+
+    // blocks stay below a kilobyte, which common allocators serve from their small object caches.
+    // glibc for one consolidates its free lists before every larger request, and that costs more
+    // than a whole document of numbers when the rest of the parse has just freed many small blocks
+    static const std::size_t block_size = 1000;
+
+    std::atomic<std::size_t> count{ 1 };
+    block* head = nullptr;
+
+    number_arena() = default;
+
+    ~number_arena() {
+        while(head != nullptr) {
+            auto next = head->next;
+            ::operator delete(head);
+            head = next;
+        }
+    }
+
+    // a block of the usual size becomes the one stored into, anything else is
+    // kept behind the current block so that the space left in it is still used
+    block* grow(std::size_t capacity) {
+        auto b = static_cast<block*>(::operator new(sizeof(block) + capacity));
+        b->capacity = capacity;
+        b->used = 0;
+        if(head != nullptr && capacity != block_size - sizeof(block)) {
+            b->next = head->next;
+            head->next = b;
+        }
+        else {
+            b->next = head;
+            head = b;
+        }
+        return b;
+    }
+public:
+    // the arena starts with the reference of its creator
+    static number_arena* create() {
+        return new number_arena();
+    }
+
+    number_arena(const number_arena&) = delete;
+    number_arena& operator=(const number_arena&) = delete;
+
+    void retain() JSONPP_NOEXCEPT {
+        count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void release() JSONPP_NOEXCEPT {
+        if(count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete this;
+        }
+    }
+
+    // the space taken by an entry holding size digits
+    static std::size_t entry_size(std::size_t size) JSONPP_NOEXCEPT {
+        auto bytes = sizeof(arena_digits) + size + 1;
+        return (bytes + alignof(arena_digits) - 1) / alignof(arena_digits) * alignof(arena_digits);
+    }
+
+    // copies the digits into the arena, the result holds a reference to it
+    // only one thread may store into an arena, usually the parser that created it
+    const arena_digits* store(const char* digits, std::size_t size) {
+        auto bytes = entry_size(size);
+        auto b = head;
+        if(b == nullptr || b->capacity - b->used < bytes) {
+            b = grow(bytes > block_size - sizeof(block) ? bytes : block_size - sizeof(block));
+        }
+
+        auto memory = b->data() + b->used;
+        b->used += bytes;
+        auto result = new(memory) arena_digits{ this, size };
+        std::memcpy(memory + sizeof(arena_digits), digits, size);
+        memory[sizeof(arena_digits) + size] = '\0';
+        retain();
+        return result;
+    }
+
+    // stores the digits in a block of their own, for an arena that only ever holds one number
+    const arena_digits* store_alone(const char* digits, std::size_t size) {
+        grow(entry_size(size));
+        return store(digits, size);
+    }
+};
+
+// stores the digits of a single number in an arena of its own
+inline const arena_digits* make_digits(const char* digits, std::size_t size) {
+    auto arena = number_arena::create();
+    auto result = arena->store_alone(digits, size);
+    arena->release();
+    return result;
+}
+
+inline const arena_digits* copy_digits(const arena_digits* digits) JSONPP_NOEXCEPT {
+    digits->arena->retain();
+    return digits;
+}
+
+inline void release_digits(const arena_digits* digits) JSONPP_NOEXCEPT {
+    digits->arena->release();
+}
+
+// the arena a parser stores into, each parser starts with an empty one
+// and the arena is only created once the first number is kept
+class arena_ref {
+private:
+    number_arena* arena = nullptr;
+public:
+    arena_ref() = default;
+    arena_ref(const arena_ref&) JSONPP_NOEXCEPT {}
+
+    arena_ref& operator=(const arena_ref&) JSONPP_NOEXCEPT {
+        reset();
+        return *this;
+    }
+
+    ~arena_ref() {
+        reset();
+    }
+
+    // drops the reference of the parser so the arena only lives as long as its numbers
+    void reset() JSONPP_NOEXCEPT {
+        if(arena != nullptr) {
+            arena->release();
+            arena = nullptr;
+        }
+    }
+
+    const arena_digits* store(const char* digits, std::size_t size) {
+        if(arena == nullptr) {
+            arena = number_arena::create();
+        }
+        return arena->store(digits, size);
+    }
+};
+} // detail
+} // json
+
+#endif // JSONPP_DETAIL_ARENA_HPP
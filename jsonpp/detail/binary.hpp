@@ -0,0 +1,233 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef JSONPP_DETAIL_BINARY_HPP
+#define JSONPP_DETAIL_BINARY_HPP
+
+#include "../error.hpp"
+#include "../value.hpp"
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <string>
+
+namespace json {
+namespace detail {
+template<typename OStream>
+inline void write_byte(OStream& out, unsigned byte) {
+    out.put(static_cast<char>(byte));
+}
+
+// writes the lower size bytes of n most significant byte first
+template<typename OStream>
+inline void write_big_endian(OStream& out, std::uint64_t n, std::size_t size) {
+    char buffer[8];
+    for(std::size_t i = size; i != 0; --i) {
+        buffer[i - 1] = static_cast<char>(n & 0xFF);
+        n >>= 8;
+    }
+    out.write(buffer, size);
+}
+
+inline std::uint64_t double_bits(double d) JSONPP_NOEXCEPT {
+    std::uint64_t bits;
+    std::memcpy(&bits, &d, sizeof(bits));
+    return bits;
+}
+
+inline double bits_to_double(std::uint64_t bits) JSONPP_NOEXCEPT {
+    double d;
+    std::memcpy(&d, &bits, sizeof(d));
+    return d;
+}
+
+inline float bits_to_float(std::uint32_t bits) JSONPP_NOEXCEPT {
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+// writes a double as single precision when that loses nothing
+template<typename OStream>
+inline void write_float(OStream& out, double d, unsigned code32, unsigned code64) {
+    float f = static_cast<float>(std::fabs(d) <= std::numeric_limits<float>::max() ? d : 0);
+    if(static_cast<double>(f) == d) {
+        std::uint32_t bits;
+        std::memcpy(&bits, &f, sizeof(bits));
+        write_byte(out, code32);
+        write_big_endian(out, bits, 4);
+    }
+    else {
+        write_byte(out, code64);
+        write_big_endian(out, double_bits(d), 8);
+    }
+}
+
+// a number as the binary formats store it
+// integral numbers are written as integers since that is usually smaller than a double
+// and keeps numbers parsed with parse_options::lazy_numbers exact
+struct binary_number {
+    enum : int {
+        positive, negative, floating
+    };
+
+    int kind = floating;
+    std::uint64_t magnitude = 0; // for negative numbers this is -(n + 1)
+    double number = 0.0;
+};
+
+inline binary_number classify_number(const value& v) {
+    binary_number result;
+    result.number = v.as<double>();
+    double d = result.number;
+    if(d == 18446744073709551616.0) {
+        // the digits of the largest integers round up to 2^64
+        auto digits = v.number_text();
+        if(is_integral_text(digits)) {
+            errno = 0;
+            auto n = std::strtoull(digits.c_str(), nullptr, 10);
+            if(errno != ERANGE) {
+                result.kind = binary_number::positive;
+                result.magnitude = n;
+            }
+        }
+        return result;
+    }
+
+    // negative zero is written as a float to keep its sign
+    if(d != std::floor(d) || d < -9223372036854775808.0 || d >= 18446744073709551616.0 || (d == 0 && std::signbit(d))) {
+        return result;
+    }
+
+    if(d >= 0) {
+        result.kind = binary_number::positive;
+        // as<T> reads lazily parsed digits exactly
+        result.magnitude = v.as<std::uint64_t>();
+    }
+    else {
+        result.kind = binary_number::negative;
+        result.magnitude = static_cast<std::uint64_t>(-(v.as<std::int64_t>() + 1));
+    }
+    return result;
+}
+
+// integers that a double cannot hold exactly are kept as their digits
+inline value integer_value(std::uint64_t n) {
+    if(n <= 9007199254740992ull) {
+        return static_cast<double>(n);
+    }
+    return value(raw_number, std::to_string(n));
+}
+
+inline value negative_integer_value(std::uint64_t magnitude) {
+    // the number is -(magnitude + 1)
+    if(magnitude < 9007199254740992ull) {
+        return -static_cast<double>(magnitude) - 1.0;
+    }
+    return value(raw_number, '-' + (magnitude == UINT64_MAX ? std::string("18446744073709551616") : std::to_string(magnitude + 1)));
+}
+
+// the deepest nesting of arrays and objects decoded by default
+constexpr std::size_t default_binary_depth = 512;
+
+// bounds checked reading of binary input
+// errors are reported with the byte offset as the column
+class byte_reader {
+private:
+    const unsigned char* first;
+    const unsigned char* current;
+    const unsigned char* last;
+    std::size_t depth_left;
+public:
+    byte_reader(const char* data, std::size_t size, std::size_t max_depth = default_binary_depth) JSONPP_NOEXCEPT:
+        first(reinterpret_cast<const unsigned char*>(data)), current(first), last(first + size), depth_left(max_depth) {}
+
+    [[noreturn]] void fail(const std::string& str) const {
+        throw parser_error(str, 1, static_cast<unsigned>(current - first) + 1);
+    }
+
+    std::size_t remaining() const JSONPP_NOEXCEPT {
+        return static_cast<std::size_t>(last - current);
+    }
+
+    bool done() const JSONPP_NOEXCEPT {
+        return current == last;
+    }
+
+    void need(std::uint64_t size) const {
+        if(size > remaining()) {
+            fail("unexpected end of input");
+        }
+    }
+
+    unsigned peek() const {
+        need(1);
+        return *current;
+    }
+
+    unsigned byte() {
+        need(1);
+        return *current++;
+    }
+
+    std::uint64_t big_endian(std::size_t size) {
+        need(size);
+        std::uint64_t result = 0;
+        for(std::size_t i = 0; i < size; ++i) {
+            result = (result << 8) | current[i];
+        }
+        current += size;
+        return result;
+    }
+
+    void append(std::string& str, std::uint64_t size) {
+        need(size);
+        str.append(reinterpret_cast<const char*>(current), static_cast<std::size_t>(size));
+        current += size;
+    }
+
+    // the decoders recurse for every array and object, so the nesting is limited
+    // before a few bytes of input per level can exhaust the stack
+    void enter() {
+        if(depth_left == 0) {
+            fail("maximum nesting depth exceeded");
+        }
+        --depth_left;
+    }
+
+    void leave() JSONPP_NOEXCEPT {
+        ++depth_left;
+    }
+
+    // every element takes at least a byte so a size larger than the input is malformed
+    // checking it up front also keeps hostile sizes from reserving huge amounts of memory
+    std::size_t count(std::uint64_t size) const {
+        need(size);
+        return static_cast<std::size_t>(size);
+    }
+};
+} // detail
+} // json
+
+#endif // JSONPP_DETAIL_BINARY_HPP
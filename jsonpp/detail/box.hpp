@@ -0,0 +1,127 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef JSONPP_DETAIL_BOX_HPP
+#define JSONPP_DETAIL_BOX_HPP
+
+#include "../config.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#if defined(JSONPP_COPY_ON_WRITE)
+#include <unordered_set>
+#endif
+
+namespace json {
+namespace detail {
+// the heap allocated payload of a string, array or object value
+// with JSONPP_COPY_ON_WRITE copies share the box and the first mutable access
+// to a shared box clones it, otherwise every copy owns a box of its own
+template<typename T>
+struct box {
+#if defined(JSONPP_COPY_ON_WRITE)
+    std::atomic<std::size_t> count{ 1 };
+    // cleared once a mutable reference to data was handed out. it may still be written
+    // through after the value is copied, so from then on copies get a box of their own
+    bool shareable = true;
+#endif
+    T data;
+#if defined(JSONPP_MEMOIZE_HASH)
+    // the memoized structural hash of data or zero, cleared by unshare_box
+    mutable std::atomic<std::uint64_t> hash{ 0 };
+#endif
+
+    template<typename... Args>
+    explicit box(Args&&... args): data(std::forward<Args>(args)...) {}
+};
+
+template<typename T, typename... Args>
+inline box<T>* make_box(Args&&... args) {
+    return new box<T>(std::forward<Args>(args)...);
+}
+
+template<typename T>
+inline box<T>* copy_box(box<T>* b) {
+#if defined(JSONPP_COPY_ON_WRITE)
+    if(b->shareable) {
+        b->count.fetch_add(1, std::memory_order_relaxed);
+        return b;
+    }
+#endif
+    return new box<T>(b->data);
+}
+
+template<typename T>
+inline void release_box(box<T>* b) JSONPP_NOEXCEPT {
+#if defined(JSONPP_COPY_ON_WRITE)
+    if(b->count.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+#endif
+    delete b;
+}
+
+// makes sure the box is not shared before it is mutated
+// every non-const access to the payload of a value goes through here, which is what
+// keeps a memoized hash valid: it is cleared whenever a mutable pointer or reference
+// is handed out, so equality may reject on differing memoized hashes. a reference
+// obtained before hashing and written through afterwards bypasses this and leaves a
+// stale hash behind. copy on write does not have that problem since the box is
+// never shared again once a reference to it was handed out
+template<typename T>
+inline box<T>* unshare_box(box<T>*& b) {
+#if defined(JSONPP_COPY_ON_WRITE)
+    if(b->count.load(std::memory_order_acquire) != 1) {
+        auto result = new box<T>(b->data);
+        release_box(b);
+        b = result;
+    }
+    b->shareable = false;
+#endif
+#if defined(JSONPP_MEMOIZE_HASH)
+    b->hash.store(0, std::memory_order_relaxed);
+#endif
+    return b;
+}
+
+// the boxes already visited by a walk over a value, so that shared ones are visited once
+#if defined(JSONPP_COPY_ON_WRITE)
+class seen_boxes {
+private:
+    std::unordered_set<const void*> boxes;
+public:
+    // returns whether the box is visited for the first time
+    bool insert(const void* b) {
+        return boxes.insert(b).second;
+    }
+};
+#else
+struct seen_boxes {
+    bool insert(const void*) JSONPP_NOEXCEPT {
+        return true;
+    }
+};
+#endif
+} // detail
+} // json
+
+#endif // JSONPP_DETAIL_BOX_HPP
@@ -0,0 +1,366 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef JSONPP_DETAIL_DTOA_HPP
+#define JSONPP_DETAIL_DTOA_HPP
+
+#include "../config.hpp"
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cmath>
+
+namespace json {
+namespace detail {
+// Grisu2 shortest round-trip double formatting, see
+// Florian Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with Integers"
+namespace grisu {
+struct diyfp {
+    std::uint64_t f;
+    int e;
+};
+
+inline diyfp sub(diyfp x, diyfp y) JSONPP_NOEXCEPT {
+    return { x.f - y.f, x.e };
+}
+
+// computes x * y / 2^64 rounded to nearest, ties up
+inline diyfp mul(diyfp x, diyfp y) JSONPP_NOEXCEPT {
+    const std::uint64_t u_lo = x.f & 0xFFFFFFFFu;
+    const std::uint64_t u_hi = x.f >> 32;
+    const std::uint64_t v_lo = y.f & 0xFFFFFFFFu;
+    const std::uint64_t v_hi = y.f >> 32;
+
+    const std::uint64_t p0 = u_lo * v_lo;
+    const std::uint64_t p1 = u_lo * v_hi;
+    const std::uint64_t p2 = u_hi * v_lo;
+    const std::uint64_t p3 = u_hi * v_hi;
+
+    std::uint64_t q = (p0 >> 32) + (p1 & 0xFFFFFFFFu) + (p2 & 0xFFFFFFFFu);
+    q += std::uint64_t{1} << 31;
+    return { p3 + (p2 >> 32) + (p1 >> 32) + (q >> 32), x.e + y.e + 64 };
+}
+
+inline diyfp normalize(diyfp x) JSONPP_NOEXCEPT {
+    while((x.f >> 63) == 0) {
+        x.f <<= 1;
+        --x.e;
+    }
+    return x;
+}
+
+struct boundaries {
+    diyfp w;
+    diyfp minus;
+    diyfp plus;
+};
+
+// computes the normalized value and the boundaries of the interval
+// of real numbers that round to it
+inline boundaries compute_boundaries(double value) JSONPP_NOEXCEPT {
+    const std::uint64_t hidden_bit = std::uint64_t{1} << 52;
+    const int bias = 1075;
+
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const std::uint64_t exponent = bits >> 52;
+    const std::uint64_t fraction = bits & (hidden_bit - 1);
+
+    const diyfp v = exponent == 0 ? diyfp{ fraction, 1 - bias }
+                                  : diyfp{ fraction + hidden_bit, static_cast<int>(exponent) - bias };
+
+    // the lower boundary is closer if the fraction is zero except for the smallest exponent
+    const bool lower_is_closer = fraction == 0 && exponent > 1;
+    const diyfp plus = normalize({ 2 * v.f + 1, v.e - 1 });
+    const diyfp minus = lower_is_closer ? diyfp{ 4 * v.f - 1, v.e - 2 } : diyfp{ 2 * v.f - 1, v.e - 1 };
+
+    return { normalize(v), { minus.f << (minus.e - plus.e), plus.e }, plus };
+}
+
+// the product of w and the cached power has a binary exponent in [alpha, -32]
+const int alpha = -60;
+
+struct cached_power {
+    std::uint64_t f;
+    int e;
+    int k;
+};
+
+// returns a normalized 10^k with alpha <= e + cached.e + 64 <= -32
+inline cached_power get_cached_power(int e) JSONPP_NOEXCEPT {
+    static const cached_power powers[] = {
+        { 0xAB70FE17C79AC6CA, -1060, -300 },
+        { 0xFF77B1FCBEBCDC4F, -1034, -292 },
+        { 0xBE5691EF416BD60C, -1007, -284 },
+        { 0x8DD01FAD907FFC3C,  -980, -276 },
+        { 0xD3515C2831559A83,  -954, -268 },
+        { 0x9D71AC8FADA6C9B5,  -927, -260 },
+        { 0xEA9C227723EE8BCB,  -901, -252 },
+        { 0xAECC49914078536D,  -874, -244 },
+        { 0x823C12795DB6CE57,  -847, -236 },
+        { 0xC21094364DFB5637,  -821, -228 },
+        { 0x9096EA6F3848984F,  -794, -220 },
+        { 0xD77485CB25823AC7,  -768, -212 },
+        { 0xA086CFCD97BF97F4,  -741, -204 },
+        { 0xEF340A98172AACE5,  -715, -196 },
+        { 0xB23867FB2A35B28E,  -688, -188 },
+        { 0x84C8D4DFD2C63F3B,  -661, -180 },
+        { 0xC5DD44271AD3CDBA,  -635, -172 },
+        { 0x936B9FCEBB25C996,  -608, -164 },
+        { 0xDBAC6C247D62A584,  -582, -156 },
+        { 0xA3AB66580D5FDAF6,  -555, -148 },
+        { 0xF3E2F893DEC3F126,  -529, -140 },
+        { 0xB5B5ADA8AAFF80B8,  -502, -132 },
+        { 0x87625F056C7C4A8B,  -475, -124 },
+        { 0xC9BCFF6034C13053,  -449, -116 },
+        { 0x964E858C91BA2655,  -422, -108 },
+        { 0xDFF9772470297EBD,  -396, -100 },
+        { 0xA6DFBD9FB8E5B88F,  -369,  -92 },
+        { 0xF8A95FCF88747D94,  -343,  -84 },
+        { 0xB94470938FA89BCF,  -316,  -76 },
+        { 0x8A08F0F8BF0F156B,  -289,  -68 },
+        { 0xCDB02555653131B6,  -263,  -60 },
+        { 0x993FE2C6D07B7FAC,  -236,  -52 },
+        { 0xE45C10C42A2B3B06,  -210,  -44 },
+        { 0xAA242499697392D3,  -183,  -36 },
+        { 0xFD87B5F28300CA0E,  -157,  -28 },
+        { 0xBCE5086492111AEB,  -130,  -20 },
+        { 0x8CBCCC096F5088CC,  -103,  -12 },
+        { 0xD1B71758E219652C,   -77,   -4 },
+        { 0x9C40000000000000,   -50,    4 },
+        { 0xE8D4A51000000000,   -24,   12 },
+        { 0xAD78EBC5AC620000,     3,   20 },
+        { 0x813F3978F8940984,    30,   28 },
+        { 0xC097CE7BC90715B3,    56,   36 },
+        { 0x8F7E32CE7BEA5C70,    83,   44 },
+        { 0xD5D238A4ABE98068,   109,   52 },
+        { 0x9F4F2726179A2245,   136,   60 },
+        { 0xED63A231D4C4FB27,   162,   68 },
+        { 0xB0DE65388CC8ADA8,   189,   76 },
+        { 0x83C7088E1AAB65DB,   216,   84 },
+        { 0xC45D1DF942711D9A,   242,   92 },
+        { 0x924D692CA61BE758,   269,  100 },
+        { 0xDA01EE641A708DEA,   295,  108 },
+        { 0xA26DA3999AEF774A,   322,  116 },
+        { 0xF209787BB47D6B85,   348,  124 },
+        { 0xB454E4A179DD1877,   375,  132 },
+        { 0x865B86925B9BC5C2,   402,  140 },
+        { 0xC83553C5C8965D3D,   428,  148 },
+        { 0x952AB45CFA97A0B3,   455,  156 },
+        { 0xDE469FBD99A05FE3,   481,  164 },
+        { 0xA59BC234DB398C25,   508,  172 },
+        { 0xF6C69A72A3989F5C,   534,  180 },
+        { 0xB7DCBF5354E9BECE,   561,  188 },
+        { 0x88FCF317F22241E2,   588,  196 },
+        { 0xCC20CE9BD35C78A5,   614,  204 },
+        { 0x98165AF37B2153DF,   641,  212 },
+        { 0xE2A0B5DC971F303A,   667,  220 },
+        { 0xA8D9D1535CE3B396,   694,  228 },
+        { 0xFB9B7CD9A4A7443C,   720,  236 },
+        { 0xBB764C4CA7A44410,   747,  244 },
+        { 0x8BAB8EEFB6409C1A,   774,  252 },
+        { 0xD01FEF10A657842C,   800,  260 },
+        { 0x9B10A4E5E9913129,   827,  268 },
+        { 0xE7109BFBA19C0C9D,   853,  276 },
+        { 0xAC2820D9623BF429,   880,  284 },
+        { 0x80444B5E7AA7CF85,   907,  292 },
+        { 0xBF21E44003ACDD2D,   933,  300 },
+        { 0x8E679C2F5E44FF8F,   960,  308 },
+        { 0xD433179D9C8CB841,   986,  316 },
+        { 0x9E19DB92B4E31BA9,  1013,  324 },
+    };
+
+    // k = ceil((alpha - e - 1) * log10(2)) without floating point arithmetic
+    const int min_exponent = -300;
+    const int step = 8;
+    const int x = alpha - e - 1;
+    const int k = (x * 78913) / (1 << 18) + static_cast<int>(x > 0);
+    const int index = (-min_exponent + k + (step - 1)) / step;
+    return powers[index];
+}
+
+// returns the number of decimal digits of n and sets pow10 to 10^(digits - 1)
+inline int largest_pow10(std::uint32_t n, std::uint32_t& pow10) JSONPP_NOEXCEPT {
+    static const std::uint32_t powers[] = {
+        1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+    };
+
+    int digits = 10;
+    while(digits > 1 && n < powers[digits - 1]) {
+        --digits;
+    }
+    pow10 = powers[digits - 1];
+    return digits;
+}
+
+// moves the last digit towards w while it stays inside the interval
+inline void round_weed(char* buffer, int length, std::uint64_t dist, std::uint64_t delta,
+                       std::uint64_t rest, std::uint64_t ten_k) JSONPP_NOEXCEPT {
+    while(rest < dist && delta - rest >= ten_k && (rest + ten_k < dist || dist - rest > rest + ten_k - dist)) {
+        --buffer[length - 1];
+        rest += ten_k;
+    }
+}
+
+inline void digit_gen(char* buffer, int& length, int& exponent, diyfp minus, diyfp w, diyfp plus) JSONPP_NOEXCEPT {
+    std::uint64_t delta = sub(plus, minus).f;
+    std::uint64_t dist = sub(plus, w).f;
+
+    const int shift = -plus.e;
+    const std::uint64_t one = std::uint64_t{1} << shift;
+
+    // split plus into its integral and fractional part
+    auto p1 = static_cast<std::uint32_t>(plus.f >> shift);
+    std::uint64_t p2 = plus.f & (one - 1);
+
+    std::uint32_t pow10;
+    int n = largest_pow10(p1, pow10);
+
+    while(n > 0) {
+        buffer[length++] = static_cast<char>('0' + p1 / pow10);
+        p1 %= pow10;
+        --n;
+
+        const std::uint64_t rest = (static_cast<std::uint64_t>(p1) << shift) + p2;
+        if(rest <= delta) {
+            exponent += n;
+            round_weed(buffer, length, dist, delta, rest, static_cast<std::uint64_t>(pow10) << shift);
+            return;
+        }
+        pow10 /= 10;
+    }
+
+    int m = 0;
+    while(true) {
+        p2 *= 10;
+        buffer[length++] = static_cast<char>('0' + (p2 >> shift));
+        p2 &= one - 1;
+        ++m;
+        delta *= 10;
+        dist *= 10;
+        if(p2 <= delta) {
+            break;
+        }
+    }
+
+    exponent -= m;
+    round_weed(buffer, length, dist, delta, p2, one);
+}
+
+// writes the shortest digits of a positive finite value such that
+// value == buffer * 10^exponent when read back
+inline void grisu2(char* buffer, int& length, int& exponent, double value) JSONPP_NOEXCEPT {
+    const boundaries b = compute_boundaries(value);
+    const cached_power cached = get_cached_power(b.plus.e);
+    const diyfp c = { cached.f, cached.e };
+
+    const diyfp w = mul(b.w, c);
+    const diyfp minus = mul(b.minus, c);
+    const diyfp plus = mul(b.plus, c);
+
+    length = 0;
+    exponent = -cached.k;
+    digit_gen(buffer, length, exponent, { minus.f + 1, minus.e }, w, { plus.f - 1, plus.e });
+}
+} // grisu
+
+// writes the exponent in the same format as printf, i.e. e+05
+inline char* write_exponent(char* out, int exponent) JSONPP_NOEXCEPT {
+    *out++ = 'e';
+    if(exponent < 0) {
+        *out++ = '-';
+        exponent = -exponent;
+    }
+    else {
+        *out++ = '+';
+    }
+
+    if(exponent >= 100) {
+        *out++ = static_cast<char>('0' + exponent / 100);
+        exponent %= 100;
+    }
+    *out++ = static_cast<char>('0' + exponent / 10);
+    *out++ = static_cast<char>('0' + exponent % 10);
+    return out;
+}
+
+// writes the shortest representation of a finite double that reads back
+// to the same value into out, which must hold at least 32 characters
+// returns the end of the written characters
+inline char* shortest_double(char* out, double value) JSONPP_NOEXCEPT {
+    if(value < 0 || (value == 0 && std::signbit(value))) {
+        *out++ = '-';
+        value = -value;
+    }
+
+    if(value == 0) {
+        *out++ = '0';
+        return out;
+    }
+
+    char digits[18];
+    int length = 0;
+    int exponent = 0;
+    grisu::grisu2(digits, length, exponent, value);
+
+    // the exponent if written as d.ddde+xx
+    const int scientific = length + exponent - 1;
+
+    if(scientific < -4 || scientific >= 17) {
+        *out++ = digits[0];
+        if(length > 1) {
+            *out++ = '.';
+            std::memcpy(out, digits + 1, static_cast<std::size_t>(length - 1));
+            out += length - 1;
+        }
+        return write_exponent(out, scientific);
+    }
+
+    if(exponent >= 0) {
+        // integral value, dddd000
+        std::memcpy(out, digits, static_cast<std::size_t>(length));
+        out += length;
+        std::memset(out, '0', static_cast<std::size_t>(exponent));
+        return out + exponent;
+    }
+
+    const int point = length + exponent;
+    if(point > 0) {
+        // ddd.ddd
+        std::memcpy(out, digits, static_cast<std::size_t>(point));
+        out += point;
+        *out++ = '.';
+        std::memcpy(out, digits + point, static_cast<std::size_t>(length - point));
+        return out + (length - point);
+    }
+
+    // 0.000ddd
+    *out++ = '0';
+    *out++ = '.';
+    std::memset(out, '0', static_cast<std::size_t>(-point));
+    out += -point;
+    std::memcpy(out, digits, static_cast<std::size_t>(length));
+    return out + length;
+}
+} // detail
+} // json
+
+#endif // JSONPP_DETAIL_DTOA_HPP
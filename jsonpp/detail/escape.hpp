@@ -0,0 +1,135 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef JSONPP_DETAIL_ESCAPE_HPP
+#define JSONPP_DETAIL_ESCAPE_HPP
+
+#include "../config.hpp"
+#include <cstdint>
+#include <cstring>
+
+#if defined(JSONPP_AVX2)
+#include <immintrin.h>
+#elif defined(JSONPP_SSE2)
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace json {
+namespace detail {
+inline bool needs_escape(char ch) JSONPP_NOEXCEPT {
+    auto byte = static_cast<unsigned char>(ch);
+    return byte <= 0x1F || ch == '"' || ch == '\\' || ch == '/';
+}
+
+inline bool needs_escape(char ch, bool ascii) JSONPP_NOEXCEPT {
+    return needs_escape(ch) || (ascii && static_cast<unsigned char>(ch) >= 0x80);
+}
+
+inline int count_trailing_zeros(std::uint32_t mask) JSONPP_NOEXCEPT {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+// returns the first character in [first, last) that has to be escaped, or last
+// if ascii is true then bytes of multi-byte sequences are also searched for
+inline const char* find_escape(const char* first, const char* last, bool ascii = false) JSONPP_NOEXCEPT {
+#if defined(JSONPP_AVX2)
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i slash = _mm256_set1_epi8('/');
+    const __m256i control = _mm256_set1_epi8(0x1F);
+    while(last - first >= 32) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+        // unsigned chunk <= 0x1F is the same as min(chunk, 0x1F) == chunk
+        __m256i found = _mm256_cmpeq_epi8(_mm256_min_epu8(chunk, control), chunk);
+        found = _mm256_or_si256(found, _mm256_cmpeq_epi8(chunk, quote));
+        found = _mm256_or_si256(found, _mm256_cmpeq_epi8(chunk, backslash));
+        found = _mm256_or_si256(found, _mm256_cmpeq_epi8(chunk, slash));
+        auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(found));
+        if(ascii) {
+            mask |= static_cast<std::uint32_t>(_mm256_movemask_epi8(chunk));
+        }
+        if(mask != 0) {
+            return first + count_trailing_zeros(mask);
+        }
+        first += 32;
+    }
+#endif
+#if defined(JSONPP_SSE2) || defined(JSONPP_AVX2)
+    const __m128i quote16 = _mm_set1_epi8('"');
+    const __m128i backslash16 = _mm_set1_epi8('\\');
+    const __m128i slash16 = _mm_set1_epi8('/');
+    const __m128i control16 = _mm_set1_epi8(0x1F);
+    while(last - first >= 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        __m128i found = _mm_cmpeq_epi8(_mm_min_epu8(chunk, control16), chunk);
+        found = _mm_or_si128(found, _mm_cmpeq_epi8(chunk, quote16));
+        found = _mm_or_si128(found, _mm_cmpeq_epi8(chunk, backslash16));
+        found = _mm_or_si128(found, _mm_cmpeq_epi8(chunk, slash16));
+        auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(found));
+        if(ascii) {
+            mask |= static_cast<std::uint32_t>(_mm_movemask_epi8(chunk));
+        }
+        if(mask != 0) {
+            return first + count_trailing_zeros(mask);
+        }
+        first += 16;
+    }
+#else
+    // checks 8 bytes at a time with the usual bit tricks to find bytes
+    // that are less than 0x20 or equal to one of the special characters
+    const std::uint64_t ones = 0x0101010101010101ull;
+    const std::uint64_t highs = 0x8080808080808080ull;
+    while(last - first >= 8) {
+        std::uint64_t chunk;
+        std::memcpy(&chunk, first, sizeof(chunk));
+        const std::uint64_t quote = chunk ^ (ones * '"');
+        const std::uint64_t backslash = chunk ^ (ones * '\\');
+        const std::uint64_t slash = chunk ^ (ones * '/');
+        const std::uint64_t found = ((chunk - ones * 0x20) & ~chunk) |
+                                    ((quote - ones) & ~quote) |
+                                    ((backslash - ones) & ~backslash) |
+                                    ((slash - ones) & ~slash) |
+                                    (ascii ? chunk : 0);
+        if((found & highs) != 0) {
+            break;
+        }
+        first += 8;
+    }
+#endif
+    while(first != last && !needs_escape(*first, ascii)) {
+        ++first;
+    }
+    return first;
+}
+} // detail
+} // json
+
+#endif // JSONPP_DETAIL_ESCAPE_HPP
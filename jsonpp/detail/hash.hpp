@@ -0,0 +1,58 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef JSONPP_DETAIL_HASH_HPP
+#define JSONPP_DETAIL_HASH_HPP
+
+#include "../config.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace json {
+namespace detail {
+// the finaliser of MurmurHash3
+inline std::uint64_t mix64(std::uint64_t h) JSONPP_NOEXCEPT {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// hashes 8 bytes at a time, the result depends on the byte order of the platform
+inline std::uint64_t hash_bytes(const char* str, std::size_t size) JSONPP_NOEXCEPT {
+    std::uint64_t h = 0x9e3779b97f4a7c15ULL ^ size;
+    std::uint64_t word;
+    for(; size >= 8; str += 8, size -= 8) {
+        std::memcpy(&word, str, 8);
+        h = mix64(h ^ word);
+    }
+
+    word = 0;
+    std::memcpy(&word, str, size);
+    return mix64(h ^ word ^ (static_cast<std::uint64_t>(size) << 56));
+}
+} // detail
+} // json
+
+#endif // JSONPP_DETAIL_HASH_HPP
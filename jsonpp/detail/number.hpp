@@ -0,0 +1,131 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef JSONPP_DETAIL_NUMBER_HPP
+#define JSONPP_DETAIL_NUMBER_HPP
+
+#include "../type_traits.hpp"
+#include <algorithm>
+#include <string>
+#include <cstdlib>
+#include <cerrno>
+
+namespace json {
+namespace detail {
+inline bool is_digit(char ch) {
+    return ch >= '0' && ch <= '9';
+}
+
+// scans a number according to the JSON grammar
+// returns the end of the number or nullptr if it's malformed
+inline const char* scan_number(const char* str) {
+    if(*str == '-') {
+        ++str;
+    }
+
+    if(*str == '0') {
+        ++str;
+    }
+    else if(is_digit(*str)) {
+        while(is_digit(*str)) {
+            ++str;
+        }
+    }
+    else {
+        return nullptr;
+    }
+
+    if(*str == '.') {
+        ++str;
+        if(!is_digit(*str)) {
+            return nullptr;
+        }
+
+        while(is_digit(*str)) {
+            ++str;
+        }
+    }
+
+    if(*str == 'e' || *str == 'E') {
+        ++str;
+        if(*str == '+' || *str == '-') {
+            ++str;
+        }
+
+        if(!is_digit(*str)) {
+            return nullptr;
+        }
+
+        while(is_digit(*str)) {
+            ++str;
+        }
+    }
+
+    return str;
+}
+
+inline bool is_integral_text(const char* digits, std::size_t size) JSONPP_NOEXCEPT {
+    return std::find_if(digits, digits + size, [](char ch) { return ch == '.' || ch == 'e' || ch == 'E'; }) == digits + size;
+}
+
+inline bool is_integral_text(const std::string& digits) JSONPP_NOEXCEPT {
+    return is_integral_text(digits.data(), digits.size());
+}
+
+// converts the null terminated digits of a number retained by the parser
+// integers that fit are converted exactly, everything else goes through double
+template<typename T, EnableIf<std::is_floating_point<T>> = 0>
+inline T from_digits(const char* digits, std::size_t) {
+    return static_cast<T>(std::strtod(digits, nullptr));
+}
+
+template<typename T, EnableIf<std::is_integral<T>, std::is_signed<T>> = 0>
+inline T from_digits(const char* digits, std::size_t size) {
+    if(is_integral_text(digits, size)) {
+        errno = 0;
+        auto result = std::strtoll(digits, nullptr, 10);
+        if(errno != ERANGE) {
+            return static_cast<T>(result);
+        }
+    }
+    return static_cast<T>(std::strtod(digits, nullptr));
+}
+
+template<typename T, EnableIf<std::is_integral<T>, std::is_unsigned<T>> = 0>
+inline T from_digits(const char* digits, std::size_t size) {
+    if(is_integral_text(digits, size) && digits[0] != '-') {
+        errno = 0;
+        auto result = std::strtoull(digits, nullptr, 10);
+        if(errno != ERANGE) {
+            return static_cast<T>(result);
+        }
+    }
+    return static_cast<T>(std::strtod(digits, nullptr));
+}
+
+template<typename T>
+inline T from_digits(const std::string& digits) {
+    return from_digits<T>(digits.c_str(), digits.size());
+}
+} // detail
+} // json
+
+#endif // JSONPP_DETAIL_NUMBER_HPP
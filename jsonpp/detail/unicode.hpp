@@ -38,6 +38,52 @@
 
 namespace json {
 namespace detail {
+// decodes the codepoint starting at first and moves first past it
+inline char32_t decode_utf8(const char*& first, const char* last) {
+    static const std::invalid_argument invalid_utf8("Invalid UTF-8 string given");
+    char32_t codepoint;
+    int iterations = 0;
+    unsigned char byte = *first++;
+    if(byte <= 0x7F) {
+        return byte;
+    }
+    else if(byte <= 0xBF) {
+        throw invalid_utf8;
+    }
+    else if(byte <= 0xDF) {
+        codepoint = byte & 0x1F;
+        iterations = 1;
+    }
+    else if(byte <= 0xEF) {
+        codepoint = byte & 0x0F;
+        iterations = 2;
+    }
+    else if(byte <= 0xF7) {
+        codepoint = byte & 0x07;
+        iterations = 3;
+    }
+    else {
+        throw invalid_utf8;
+    }
+
+    for(int j = 0; j < iterations; ++j) {
+        if(first == last) {
+            throw invalid_utf8;
+        }
+        unsigned char next_byte = *first++;
+        if(next_byte < 0x80 || next_byte > 0xBF) {
+            throw invalid_utf8;
+        }
+
+        codepoint = (codepoint << 6) + (next_byte & 0x3F);
+    }
+
+    if(codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF)) {
+        throw invalid_utf8;
+    }
+    return codepoint;
+}
+
 #if defined(_WIN32)
 inline std::u16string utf8_to_utf16(const std::string& utf8) {
     static_assert(sizeof(wchar_t) == sizeof(char16_t), "wchar_t must be 16 bits");
@@ -52,50 +98,10 @@ inline std::u16string utf8_to_utf16(const std::string& utf8) {
 #else
 inline std::u16string utf8_to_utf16(const std::string& utf8) {
     std::u16string result;
-    using size_type = decltype(utf8.size());
-    std::invalid_argument invalid_utf8("Invalid UTF-8 string given");
-    size_type i = 0;
-    while(i < utf8.size()) {
-        char32_t codepoint;
-        size_type iterations = 0;
-        unsigned char byte = utf8[i++];
-        if(byte <= 0x7F) {
-            codepoint = byte;
-        }
-        else if(byte <= 0xBF) {
-            throw invalid_utf8;
-        }
-        else if(byte <= 0xDF) {
-            codepoint = byte & 0x1F;
-            iterations = 1;
-        }
-        else if(byte <= 0xEF) {
-            codepoint = byte & 0x0F;
-            iterations = 2;
-        }
-        else if(byte <= 0xF7) {
-            codepoint = byte & 0x07;
-            iterations = 3;
-        }
-        else {
-            throw invalid_utf8;
-        }
-
-        for(size_type j = 0; j < iterations; ++j) {
-            if(i == utf8.size()) {
-                throw invalid_utf8;
-            }
-            unsigned char next_byte = utf8[i++];
-            if(next_byte < 0x80 || next_byte > 0xBF) {
-                throw invalid_utf8;
-            }
-
-            codepoint = (codepoint << 6) + (next_byte & 0x3F);
-        }
-        if(codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF)) {
-            throw invalid_utf8;
-        }
-
+    const char* first = utf8.data();
+    const char* last = first + utf8.size();
+    while(first != last) {
+        char32_t codepoint = decode_utf8(first, last);
         if(codepoint <= 0xFFFF) {
             result.push_back(codepoint);
         }
@@ -0,0 +1,167 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef JSONPP_DOCUMENT_HPP
+#define JSONPP_DOCUMENT_HPP
+
+#include "value.hpp"
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+namespace json {
+namespace detail {
+// a published version of a document and the number of references to it
+struct document_node {
+    const value doc;
+    std::atomic<std::size_t> count{ 1 };
+
+    explicit document_node(value&& v): doc(std::move(v)) {}
+};
+
+inline void release_node(document_node* node) JSONPP_NOEXCEPT {
+    if(node != nullptr && node->count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete node;
+    }
+}
+} // detail
+
+// a reference to one published version of an atomic_document or to a cached document
+// the version stays alive for as long as a reference to it exists
+class document_ref {
+private:
+    detail::document_node* node = nullptr;
+
+    friend class atomic_document;
+    friend class parse_cache;
+    explicit document_ref(detail::document_node* node) JSONPP_NOEXCEPT: node(node) {}
+public:
+    document_ref() JSONPP_NOEXCEPT = default;
+
+    document_ref(const document_ref& other) JSONPP_NOEXCEPT: node(other.node) {
+        if(node != nullptr) {
+            node->count.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    document_ref(document_ref&& other) JSONPP_NOEXCEPT: node(other.node) {
+        other.node = nullptr;
+    }
+
+    document_ref& operator=(document_ref other) JSONPP_NOEXCEPT {
+        std::swap(node, other.node);
+        return *this;
+    }
+
+    ~document_ref() {
+        detail::release_node(node);
+    }
+
+    const value* get() const JSONPP_NOEXCEPT {
+        return node != nullptr ? &node->doc : nullptr;
+    }
+
+    const value& operator*() const JSONPP_NOEXCEPT {
+        assert(node != nullptr);
+        return node->doc;
+    }
+
+    const value* operator->() const JSONPP_NOEXCEPT {
+        assert(node != nullptr);
+        return &node->doc;
+    }
+
+    explicit operator bool() const JSONPP_NOEXCEPT {
+        return node != nullptr;
+    }
+};
+
+// holds the current version of a document that is replaced as a whole
+// readers acquire the current version without locking or copying while
+// writers publish new versions, a version is destroyed once the last
+// reference to it is gone
+//
+// a reader announces itself in one of two counters picked by the epoch before
+// it loads the current version, publish flips the epoch and waits for the
+// readers in the old counter to take their reference before it drops its own
+class atomic_document {
+private:
+    std::atomic<detail::document_node*> current;
+    mutable std::atomic<unsigned> epoch{ 0 };
+    mutable std::atomic<std::size_t> readers[2];
+    std::mutex writer;
+public:
+    atomic_document() JSONPP_NOEXCEPT: current(nullptr) {
+        readers[0] = 0;
+        readers[1] = 0;
+    }
+
+    explicit atomic_document(value v): atomic_document() {
+        current = new detail::document_node(std::move(v));
+    }
+
+    atomic_document(const atomic_document&) = delete;
+    atomic_document& operator=(const atomic_document&) = delete;
+
+    ~atomic_document() {
+        detail::release_node(current.load());
+    }
+
+    // returns the current version, which is empty if nothing was published
+    document_ref acquire() const JSONPP_NOEXCEPT {
+        std::atomic<std::size_t>* counter;
+        while(true) {
+            unsigned e = epoch.load();
+            counter = &readers[e & 1];
+            counter->fetch_add(1);
+            // a publish that flipped the epoch in between may not be waiting on this counter
+            if(epoch.load() == e) {
+                break;
+            }
+            counter->fetch_sub(1);
+        }
+
+        auto node = current.load();
+        if(node != nullptr) {
+            node->count.fetch_add(1, std::memory_order_relaxed);
+        }
+        counter->fetch_sub(1);
+        return document_ref(node);
+    }
+
+    // replaces the current version, readers holding the old one keep it until they let go
+    void publish(value v) {
+        auto node = new detail::document_node(std::move(v));
+        std::lock_guard<std::mutex> lock(writer);
+        auto old = current.exchange(node);
+
+        // readers announced under the old epoch may have loaded the old version
+        // but not taken their reference yet, new readers use the other counter
+        auto& announced = readers[epoch.fetch_add(1) & 1];
+        while(announced.load() != 0) {
+            std::this_thread::yield();
+        }
+        detail::release_node(old);
+    }
+};
+} // json
+
+#endif // JSONPP_DOCUMENT_HPP
@@ -23,11 +23,18 @@
 #define JSONPP_DUMP_HPP
 
 #include "type_traits.hpp"
+#include "sink.hpp"
+#include "fields.hpp"
+#include "stats.hpp"
 #include "detail/unicode.hpp"
+#include "detail/dtoa.hpp"
+#include "detail/escape.hpp"
 #include <string>
-#include <sstream>
 #include <iosfwd>
 #include <cmath>
+#include <cstdio>
+#include <clocale>
+#include <algorithm>
 
 namespace json {
 struct format_options {
@@ -42,65 +49,138 @@ struct format_options {
     };
 
     format_options() JSONPP_NOEXCEPT {};
-    format_options(int indent, int flags = none, int precision = 6) JSONPP_NOEXCEPT: flags(flags), indent(indent), precision(precision) {}
+    format_options(int indent, int flags = none, int precision = shortest) JSONPP_NOEXCEPT: flags(flags), indent(indent), precision(precision) {}
+
+    // precision value that requests the shortest representation that round-trips
+    static const int shortest = -1;
 
     int flags = none;
     int indent = 4;
-    int precision = 6;
+    int precision = shortest;
     int depth = 0;
 };
 
 namespace detail {
 template<typename OStream>
 inline void indent(OStream& out, const format_options& opt) {
-    out << '\n';
-    for(int i = 0; i < (opt.indent * opt.depth); ++i) {
-        out << ' ';
+    static const char spaces[] = "                                                                ";
+    out.put('\n');
+    auto count = static_cast<std::size_t>(opt.indent * opt.depth);
+    while(count > sizeof(spaces) - 1) {
+        write(out, spaces);
+        count -= sizeof(spaces) - 1;
+    }
+    write(out, spaces, count);
+}
+
+template<typename OStream, typename T>
+inline void write_integer(OStream& out, T t) {
+    char buffer[24];
+    char* last = buffer + sizeof(buffer);
+    char* first = last;
+    bool negative = t < 0;
+    // done in unsigned arithmetic so the minimum value does not overflow
+    auto value = static_cast<unsigned long long>(t);
+    if(negative) {
+        value = 0ull - value;
+    }
+
+    do {
+        *--first = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+    while(value != 0);
+
+    if(negative) {
+        *--first = '-';
+    }
+    write(out, first, static_cast<std::size_t>(last - first));
+}
+
+template<typename OStream>
+inline void write_double(OStream& out, double t, const format_options& opt) {
+    const char* format = "%.*g";
+    bool shortest = true;
+    if((opt.flags & opt.defaultfloat) == opt.defaultfloat) {
+        format = "%.*g";
     }
+    else if((opt.flags & opt.scientific) == opt.scientific) {
+        format = "%.*e";
+        shortest = false;
+    }
+    else if((opt.flags & opt.fixed) == opt.fixed) {
+        format = "%.*f";
+        shortest = false;
+    }
+
+    char buffer[64];
+    if(opt.precision < 0 && shortest && std::isfinite(t)) {
+        write(out, buffer, static_cast<std::size_t>(shortest_double(buffer, t) - buffer));
+        return;
+    }
+
+    // printf defaults to a precision of 6 when given a negative one
+    auto size = std::snprintf(buffer, sizeof(buffer), format, opt.precision, t);
+    if(size < 0) {
+        return;
+    }
+
+    std::string large;
+    char* first = buffer;
+    if(static_cast<std::size_t>(size) >= sizeof(buffer)) {
+        large.resize(static_cast<std::size_t>(size) + 1);
+        first = &large[0];
+        std::snprintf(first, large.size(), format, opt.precision, t);
+    }
+
+    // JSON always uses '.' regardless of the C locale
+    char point = *std::localeconv()->decimal_point;
+    if(point != '.') {
+        std::replace(first, first + size, point, '.');
+    }
+    write(out, first, static_cast<std::size_t>(size));
 }
 } // detail
 
+// declared up front so that containers of these types can find them
+template<typename OStream, typename T, EnableIf<has_fields<T>> = 0>
+inline OStream& dump(OStream& out, const T& t, format_options opt = {});
+
+template<typename OStream, typename T, EnableIf<has_to_json<T>, Not<Or<is_object<T>, is_string<T>, is_array<T>, has_fields<T>>>> = 0>
+inline OStream& dump(OStream& out, const T& t, format_options opt = {});
 
 template<typename OStream, typename T, EnableIf<is_null<T>> = 0>
 inline OStream& dump(OStream& out, const T&, format_options = {}) {
-    out << "null";
+    detail::write(out, "null");
     return out;
 }
 
 template<typename OStream, typename T, EnableIf<is_bool<T>> = 0>
 inline OStream& dump(OStream& out, const T& t, format_options = {}) {
-    out << (t ? "true" : "false");
+    if(t) {
+        detail::write(out, "true");
+    }
+    else {
+        detail::write(out, "false");
+    }
+    return out;
+}
+
+template<typename OStream, typename T, EnableIf<is_number<T>, std::is_integral<T>> = 0>
+inline OStream& dump(OStream& out, const T& t, format_options = {}) {
+    detail::write_integer(out, t);
     return out;
 }
 
-template<typename OStream, typename T, EnableIf<is_number<T>> = 0>
+template<typename OStream, typename T, EnableIf<is_number<T>, std::is_floating_point<T>> = 0>
 inline OStream& dump(OStream& out, const T& t, format_options opt = {}) {
     if((opt.flags & opt.allow_nan_inf) != opt.allow_nan_inf && (std::isnan(t) || std::isinf(t))) {
         // stream null instead if nan is found
-        out << "null";
+        detail::write(out, "null");
         return out;
     }
-    auto precision = out.precision();
-    auto flags = out.flags();
 
-
-    if((opt.flags & opt.defaultfloat) == opt.defaultfloat) {
-        out.unsetf(out.floatfield);
-    }
-    else if((opt.flags & opt.scientific) == opt.scientific) {
-        out.setf(out.scientific, out.floatfield);
-    }
-    else if((opt.flags & opt.fixed) == opt.fixed) {
-        out.setf(out.fixed, out.floatfield);
-    }
-    else {
-        out.unsetf(out.floatfield);
-    }
-
-    out.precision(opt.precision);
-    out << t;
-    out.precision(precision);
-    out.flags(flags);
+    detail::write_double(out, static_cast<double>(t), opt);
     return out;
 }
 
@@ -109,80 +189,116 @@ template<typename OStream>
 inline bool escape_control(OStream& out, char control) {
     switch(control) {
     case '"':
-        out << "\\\"";
+        write(out, "\\\"");
         return true;
     case '\\':
-        out << "\\\\";
+        write(out, "\\\\");
         return true;
     case '/':
-        out << "\\/";
+        write(out, "\\/");
         return true;
     case '\b':
-        out << "\\b";
+        write(out, "\\b");
         return true;
     case '\f':
-        out << "\\f";
+        write(out, "\\f");
         return true;
     case '\n':
-        out << "\\n";
+        write(out, "\\n");
         return true;
     case '\r':
-        out << "\\r";
+        write(out, "\\r");
         return true;
     case '\t':
-        out << "\\t";
+        write(out, "\\t");
         return true;
     default:
+        if(static_cast<unsigned char>(control) <= 0x1F) {
+            // the remaining control characters have no short escape
+            static const char hex[] = "0123456789abcdef";
+            char unit[] = { '\\', 'u', '0', '0', hex[control >> 4], hex[control & 0xF] };
+            write(out, unit, sizeof(unit));
+            return true;
+        }
         return false;
     }
 }
 
 template<typename OStream>
-inline OStream& escape_str(OStream& out, const std::u16string& utf16) {
-    auto fill = out.fill();
-    auto width = out.width();
-    auto flags = out.flags();
-    out << '"';
-    for(auto&& c : utf16) {
-        if(c <= 0x7F) {
-            if(escape_control(out, static_cast<char>(c))) {
-                continue;
-            }
-            out << static_cast<char>(c);
+inline void write_utf16_escape(OStream& out, char32_t codepoint) {
+    static const char hex[] = "0123456789abcdef";
+    char units[12];
+    std::size_t size = 0;
+    auto put_unit = [&units, &size](char32_t unit) {
+        units[size++] = '\\';
+        units[size++] = 'u';
+        units[size++] = hex[(unit >> 12) & 0xF];
+        units[size++] = hex[(unit >> 8) & 0xF];
+        units[size++] = hex[(unit >> 4) & 0xF];
+        units[size++] = hex[unit & 0xF];
+    };
+
+    if(codepoint <= 0xFFFF) {
+        put_unit(codepoint);
+    }
+    else {
+        codepoint -= 0x10000;
+        put_unit((codepoint >> 10) + 0xD800);
+        put_unit((codepoint & 0x3FF) + 0xDC00);
+    }
+    write(out, units, size);
+}
+
+template<typename OStream>
+inline void escape_str(OStream& out, const char* first, const char* last, bool ascii) {
+    stats_timer timer(&stats::string_time);
+    const char* begin = first;
+    out.put('"');
+    while(first != last) {
+        // copy the run of characters that don't need escaping in one go
+        const char* run = first;
+        first = find_escape(first, last, ascii);
+        if(run == begin && first != last) {
+            record_escaped_string();
+        }
+
+        if(run != first) {
+            write(out, run, static_cast<std::size_t>(first - run));
+        }
+
+        if(first == last) {
+            break;
+        }
+
+        if(static_cast<unsigned char>(*first) >= 0x80) {
+            write_utf16_escape(out, decode_utf8(first, last));
         }
         else {
-            // prepare stream
-            out << "\\u";
-            out.width(4);
-            out.fill('0');
-            out.setf(out.hex, out.basefield);
-            out << c;
-            out.width(width);
-            out.fill(fill);
-            out.flags(flags);
+            escape_control(out, *first);
+            ++first;
         }
     }
-    out << '"';
-    return out;
+    out.put('"');
+}
+
+inline void string_range(const std::string& str, const char*& first, const char*& last) JSONPP_NOEXCEPT {
+    first = str.data();
+    last = first + str.size();
+}
+
+inline void string_range(const char* str, const char*& first, const char*& last) JSONPP_NOEXCEPT {
+    first = str;
+    last = first + std::char_traits<char>::length(str);
 }
 } // detail
 
 template<typename OStream, typename T, EnableIf<is_string<T>> = 0>
 inline OStream& dump(OStream& out, const T& t, format_options opt = {}) {
     bool escape = (opt.flags & opt.escape_multi_byte) == opt.escape_multi_byte;
-    if(escape) {
-        return detail::escape_str(out, detail::utf8_to_utf16(t));
-    }
-    out << '"';
-    for(auto&& c : t) {
-        if(detail::escape_control(out, c)) {
-            continue;
-        }
-        else {
-            out << c;
-        }
-    }
-    out << '"';
+    const char* first;
+    const char* last;
+    detail::string_range(t, first, last);
+    detail::escape_str(out, first, last, escape);
     return out;
 }
 
@@ -190,7 +306,7 @@ template<typename OStream, typename T, EnableIf<is_array<T>> = 0>
 inline OStream& dump(OStream& out, const T& t, format_options opt = {}) {
     bool prettify = (opt.flags & opt.minify) != opt.minify;
     opt.depth += prettify;
-    out << '[';
+    out.put('[');
 
     using std::begin;
     using std::end;
@@ -199,7 +315,7 @@ inline OStream& dump(OStream& out, const T& t, format_options opt = {}) {
     bool first_pass = true;
     for(; first != last; ++first) {
         if(not first_pass) {
-            out << ',';
+            out.put(',');
         }
 
         if(prettify) {
@@ -217,17 +333,20 @@ inline OStream& dump(OStream& out, const T& t, format_options opt = {}) {
         }
     }
 
-    out << ']';
+    out.put(']');
     return out;
 }
 
 template<typename OStream, typename T, EnableIf<std::is_arithmetic<T>> = 0>
 inline void key(OStream& out, const T& t, const format_options&) {
-    out << '"' << std::to_string(t) << '"';
+    out.put('"');
+    detail::write(out, std::to_string(t));
+    out.put('"');
 }
 
 template<typename OStream, typename T, DisableIf<std::is_arithmetic<T>> = 0>
 inline void key(OStream& out, const T& t, const format_options& opt) {
+    detail::record_value(detail::stats_kind::key);
     dump(out, t, opt);
 }
 
@@ -235,10 +354,10 @@ template<typename OStream, typename T, EnableIf<is_object<T>> = 0>
 inline OStream& dump(OStream& out, const T& t, format_options opt = {}) {
     bool prettify = (opt.flags & format_options::minify) != format_options::minify;
     opt.depth += prettify;
-    out << '{';
+    out.put('{');
 
     using std::begin;
-    using std::endl;
+    using std::end;
 
     auto&& first = begin(t);
     auto&& last  = end(t);
@@ -248,7 +367,7 @@ inline OStream& dump(OStream& out, const T& t, format_options opt = {}) {
 
         auto&& elem = *first;
         if(not first_pass) {
-            out << ',';
+            out.put(',');
         }
 
         if(prettify) {
@@ -256,10 +375,10 @@ inline OStream& dump(OStream& out, const T& t, format_options opt = {}) {
         }
 
         key(out, elem.first, opt);
-        out << ':';
+        out.put(':');
 
         if(prettify) {
-            out << ' ';
+            out.put(' ');
         }
 
         dump(out, elem.second, opt);
@@ -274,20 +393,72 @@ inline OStream& dump(OStream& out, const T& t, format_options opt = {}) {
         }
     }
 
-    out << '}';
+    out.put('}');
     return out;
 }
 
-template<typename OStream, typename T, EnableIf<has_to_json<T>, Not<Or<is_object<T>, is_string<T>, is_array<T>>>> = 0>
-inline OStream& dump(OStream& out, const T& t, format_options opt = {}) {
+namespace detail {
+template<typename OStream>
+struct field_dumper {
+    OStream& out;
+    const format_options& opt;
+    bool prettify;
+    bool first_pass;
+
+    template<typename T>
+    void operator()(const field_name& name, const T& member) {
+        if(not first_pass) {
+            out.put(',');
+        }
+
+        if(prettify) {
+            indent(out, opt);
+        }
+
+        write(out, name.quoted, name.size + 2);
+        out.put(':');
+
+        if(prettify) {
+            out.put(' ');
+        }
+
+        dump(out, member, opt);
+        first_pass = false;
+    }
+};
+} // detail
+
+template<typename OStream, typename T, EnableIf<has_fields<T>>>
+inline OStream& dump(OStream& out, const T& t, format_options opt) {
+    bool prettify = (opt.flags & format_options::minify) != format_options::minify;
+    opt.depth += prettify;
+    out.put('{');
+
+    detail::field_dumper<OStream> dumper{ out, opt, prettify, true };
+    jsonpp_fields(t, dumper);
+
+    if(prettify) {
+        --opt.depth;
+
+        if(not dumper.first_pass) {
+            detail::indent(out, opt);
+        }
+    }
+
+    out.put('}');
+    return out;
+}
+
+template<typename OStream, typename T, EnableIf<has_to_json<T>, Not<Or<is_object<T>, is_string<T>, is_array<T>, has_fields<T>>>>>
+inline OStream& dump(OStream& out, const T& t, format_options opt) {
     return dump(out, to_json(t), opt);
 }
 
 template<typename T>
 inline std::string dump_string(const T& value, format_options opt = {}) {
-    std::ostringstream ss;
-    dump(ss, value, opt);
-    return ss.str();
+    string_sink out;
+    dump(out, value, opt);
+    return std::move(out.str());
 }
 } // json
 
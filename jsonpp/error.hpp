@@ -23,6 +23,7 @@
 #define JSONPP_ERROR_HPP
 
 #include "config.hpp"
+#include <cstddef>
 #include <string>
 #include <exception>
 
@@ -38,6 +39,18 @@ public:
         return error.c_str();
     }
 };
+
+class patch_error : public std::exception {
+private:
+    std::string error;
+public:
+    patch_error(const std::string& str, std::size_t operation):
+        error("patch operation " + std::to_string(operation) + ": error: " + str) {}
+
+    const char* what() const JSONPP_NOEXCEPT override {
+        return error.c_str();
+    }
+};
 } // json
 
 #endif // JSONPP_ERROR_HPP
@@ -0,0 +1,196 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef JSONPP_FIELDS_HPP
+#define JSONPP_FIELDS_HPP
+
+#include "type_traits.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace json {
+// the name of a member registered with JSONPP_FIELDS
+// quoted is the key as it appears in JSON, which never needs escaping
+// since member names are identifiers
+struct field_name {
+    const char* name;
+    const char* quoted;
+    std::size_t size;
+};
+
+namespace detail {
+struct any_field_visitor {
+    template<typename T>
+    void operator()(const field_name&, T&&) const {}
+};
+} // detail
+
+struct has_fields_impl {
+    template<typename T, typename U = decltype(jsonpp_fields(std::declval<const T&>(), std::declval<detail::any_field_visitor&>()))>
+    static std::true_type test(int);
+
+    template<typename...>
+    static std::false_type test(...);
+};
+
+template<typename T>
+struct has_fields : decltype(has_fields_impl::test<T>(0)) {};
+
+namespace detail {
+struct field_collector {
+    std::vector<field_name>& names;
+
+    template<typename T>
+    void operator()(const field_name& name, const T&) const {
+        names.push_back(name);
+    }
+};
+
+// FNV-1a with the seed folded into the offset basis
+inline std::uint32_t field_hash(const char* str, std::size_t size, std::uint32_t seed) JSONPP_NOEXCEPT {
+    std::uint32_t hash = 2166136261u ^ seed;
+    for(std::size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(str[i]);
+        hash *= 16777619u;
+    }
+    return hash ^ (hash >> 15);
+}
+
+// a perfect hash from the member names of a type to their position in JSONPP_FIELDS
+// the seed is searched for once when the table is built so that every name gets its
+// own slot, a lookup is then a single hash and comparison
+class field_table {
+private:
+    std::vector<field_name> names;
+    std::vector<int> slots;
+    std::uint32_t seed = 0;
+    std::uint32_t mask = 0;
+
+    bool place() {
+        std::fill(slots.begin(), slots.end(), -1);
+        for(std::size_t i = 0; i < names.size(); ++i) {
+            int& slot = slots[field_hash(names[i].name, names[i].size, seed) & mask];
+            if(slot != -1) {
+                return false;
+            }
+            slot = static_cast<int>(i);
+        }
+        return true;
+    }
+public:
+    template<typename T>
+    explicit field_table(const T& t) {
+        jsonpp_fields(t, field_collector{ names });
+
+        std::size_t size = 1;
+        while(size < names.size() * 2) {
+            size *= 2;
+        }
+
+        for(std::size_t i = 0; i < names.size(); ++i) {
+            for(std::size_t j = i + 1; j < names.size(); ++j) {
+                assert(std::strcmp(names[i].name, names[j].name) != 0 && "member listed more than once in JSONPP_FIELDS");
+            }
+        }
+
+        slots.resize(size);
+        mask = static_cast<std::uint32_t>(size - 1);
+        while(!place()) {
+            // sparse tables find a seed quickly so grow instead of searching forever
+            if(++seed % 64 == 0) {
+                slots.resize(slots.size() * 2);
+                mask = static_cast<std::uint32_t>(slots.size() - 1);
+            }
+        }
+    }
+
+    // returns the position of the member called key or -1 if there is none
+    int find(const char* key, std::size_t size) const JSONPP_NOEXCEPT {
+        int index = slots[field_hash(key, size, seed) & mask];
+        if(index != -1 && names[index].size == size && std::memcmp(names[index].name, key, size) == 0) {
+            return index;
+        }
+        return -1;
+    }
+};
+} // detail
+} // json
+
+// implementation detail of JSONPP_FIELDS, supports up to 32 members
+#define JSONPP_FIELDS_EXPAND(x) x
+#define JSONPP_FIELDS_1(m, x) m(x)
+#define JSONPP_FIELDS_2(m, x, ...) m(x) JSONPP_FIELDS_EXPAND(JSONPP_FIELDS_1(m, __VA_ARGS__))
+#define JSONPP_FIELDS_3(m, x, ...) m(x) JSONPP_FIELDS_EXPAND(JSONPP_FIELDS_2(m, __VA_ARGS__))
+#define JSONPP_FIELDS_4(m, x, ...) m(x) JSONPP_FIELDS_EXPAND(JSONPP_FIELDS_3(m, __VA_ARGS__))
+#define JSONPP_FIELDS_5(m, x, ...) m(x) JSONPP_FIELDS_EXPAND(JSONPP_FIELDS_4(m, __VA_ARGS__))
+#define JSONPP_FIELDS_6(m, x, ...) m(x) JSONPP_FIELDS_EXPAND(JSONPP_FIELDS_5(m, __VA_ARGS__))
+#define JSONPP_FIELDS_7(m, x, ...) m(x) JSONPP_FIELDS_EXPAND(JSONPP_FIELDS_6(m, __VA_ARGS__))
+#define JSONPP_FIELDS_8(m, x, ...) m(x) JSONPP_FIELDS_EXPAND(JSONPP_FIELDS_7(m, __VA_ARGS__))
+#define JSONPP_FIELDS_9(m, x, ...) m(x) JSONPP_FIELDS_EXPAND(JSONPP_FIELDS_8(m, __VA_ARGS__))
+#define JSONPP_FIELDS_10(m, x, ...) m(x) JSONPP_FIELDS_EXPAND(JSONPP_FIELDS_9(m, __VA_ARGS__))
+#define JSONPP_FIELDS_11(m, x, ...) m(x) JSONPP_FIELDS_EXPAND(JSONPP_FIELDS_10(m, __VA_ARGS__))
+#define JSONPP_FIELDS_12(m, x, ...) m(x) JSONPP_FIELDS_EXPAND(JSONPP_FIELDS_11(m, __VA_ARGS__))
+#define JSONPP_FIELDS_13(m, x, ...) m(x) JSONPP_FIELDS_EXPAND(JSONPP_FIELDS_12(m, __VA_ARGS__))
+#define JSONPP_FIELDS_14(m, x, ...) m(x) JSONPP_FIELDS_EXPAND(JSONPP_FIELDS_13(m, __VA_ARGS__))
+#define JSONPP_FIELDS_15(m, x, ...) m(x) JSONPP_FIELDS_EXPAND(JSONPP_FIELDS_14(m, __VA_ARGS__))
+#define JSONPP_FIELDS_16(m, x, ...) m(x) JSONPP_FIELDS_EXPAND(JSONPP_FIELDS_15(m, __VA_ARGS__))
+#define JSONPP_FIELDS_17(m, x, ...) m(x) JSONPP_FIELDS_EXPAND(JSONPP_FIELDS_16(m, __VA_ARGS__))
+#define JSONPP_FIELDS_18(m, x, ...) m(x) JSONPP_FIELDS_EXPAND(JSONPP_FIELDS_17(m, __VA_ARGS__))
+#define JSONPP_FIELDS_19(m, x, ...) m(x) JSONPP_FIELDS_EXPAND(JSONPP_FIELDS_18(m, __VA_ARGS__))
+#define JSONPP_FIELDS_20(m, x, ...) m(x) JSONPP_FIELDS_EXPAND(JSONPP_FIELDS_19(m, __VA_ARGS__))
+#define JSONPP_FIELDS_21(m, x, ...) m(x) JSONPP_FIELDS_EXPAND(JSONPP_FIELDS_20(m, __VA_ARGS__))
+#define JSONPP_FIELDS_22(m, x, ...) m(x) JSONPP_FIELDS_EXPAND(JSONPP_FIELDS_21(m, __VA_ARGS__))
+#define JSONPP_FIELDS_23(m, x, ...) m(x) JSONPP_FIELDS_EXPAND(JSONPP_FIELDS_22(m, __VA_ARGS__))
+#define JSONPP_FIELDS_24(m, x, ...) m(x) JSONPP_FIELDS_EXPAND(JSONPP_FIELDS_23(m, __VA_ARGS__))
+#define JSONPP_FIELDS_25(m, x, ...) m(x) JSONPP_FIELDS_EXPAND(JSONPP_FIELDS_24(m, __VA_ARGS__))
+#define JSONPP_FIELDS_26(m, x, ...) m(x) JSONPP_FIELDS_EXPAND(JSONPP_FIELDS_25(m, __VA_ARGS__))
+#define JSONPP_FIELDS_27(m, x, ...) m(x) JSONPP_FIELDS_EXPAND(JSONPP_FIELDS_26(m, __VA_ARGS__))
+#define JSONPP_FIELDS_28(m, x, ...) m(x) JSONPP_FIELDS_EXPAND(JSONPP_FIELDS_27(m, __VA_ARGS__))
+#define JSONPP_FIELDS_29(m, x, ...) m(x) JSONPP_FIELDS_EXPAND(JSONPP_FIELDS_28(m, __VA_ARGS__))
+#define JSONPP_FIELDS_30(m, x, ...) m(x) JSONPP_FIELDS_EXPAND(JSONPP_FIELDS_29(m, __VA_ARGS__))
+#define JSONPP_FIELDS_31(m, x, ...) m(x) JSONPP_FIELDS_EXPAND(JSONPP_FIELDS_30(m, __VA_ARGS__))
+#define JSONPP_FIELDS_32(m, x, ...) m(x) JSONPP_FIELDS_EXPAND(JSONPP_FIELDS_31(m, __VA_ARGS__))
+#define JSONPP_FIELDS_SELECT(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, _17, _18, _19, _20, _21, _22, _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, name, ...) name
+#define JSONPP_FIELDS_FOR_EACH(m, ...) \
+    JSONPP_FIELDS_EXPAND(JSONPP_FIELDS_SELECT(__VA_ARGS__, JSONPP_FIELDS_32, JSONPP_FIELDS_31, JSONPP_FIELDS_30, JSONPP_FIELDS_29, JSONPP_FIELDS_28, JSONPP_FIELDS_27, JSONPP_FIELDS_26, JSONPP_FIELDS_25, JSONPP_FIELDS_24, JSONPP_FIELDS_23, JSONPP_FIELDS_22, JSONPP_FIELDS_21, JSONPP_FIELDS_20, JSONPP_FIELDS_19, JSONPP_FIELDS_18, JSONPP_FIELDS_17, JSONPP_FIELDS_16, JSONPP_FIELDS_15, JSONPP_FIELDS_14, JSONPP_FIELDS_13, JSONPP_FIELDS_12, JSONPP_FIELDS_11, JSONPP_FIELDS_10, JSONPP_FIELDS_9, JSONPP_FIELDS_8, JSONPP_FIELDS_7, JSONPP_FIELDS_6, JSONPP_FIELDS_5, JSONPP_FIELDS_4, JSONPP_FIELDS_3, JSONPP_FIELDS_2, JSONPP_FIELDS_1)(m, __VA_ARGS__))
+
+#define JSONPP_FIELDS_VISIT(member) \
+    jsonpp_visitor(::json::field_name{ #member, "\"" #member "\"", sizeof(#member) - 1 }, jsonpp_object.member);
+
+// describes the members of a type so it can be dumped and parsed directly
+// must be used in the namespace of the type, e.g.
+// struct person { std::string name; int age; };
+// JSONPP_FIELDS(person, name, age)
+#define JSONPP_FIELDS(type, ...) \
+    template<typename Visitor> \
+    inline void jsonpp_fields(const type& jsonpp_object, Visitor&& jsonpp_visitor) { \
+        JSONPP_FIELDS_FOR_EACH(JSONPP_FIELDS_VISIT, __VA_ARGS__) \
+    } \
+    template<typename Visitor> \
+    inline void jsonpp_fields(type& jsonpp_object, Visitor&& jsonpp_visitor) { \
+        JSONPP_FIELDS_FOR_EACH(JSONPP_FIELDS_VISIT, __VA_ARGS__) \
+    }
+
+#endif // JSONPP_FIELDS_HPP
@@ -0,0 +1,266 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef JSONPP_GENERATOR_HPP
+#define JSONPP_GENERATOR_HPP
+
+#include "sink.hpp"
+#include <cstdint>
+
+namespace json {
+// controls the shape of the documents written by generate
+// the same options always produce the same bytes on every platform
+struct generator_options {
+    enum number_distribution : int {
+        small_integers, // 0 to 999, a quarter of them negative
+        large_integers, // up to 19 digits
+        decimals,       // up to five integer and six fractional digits
+        exponents,      // scientific notation with exponents up to 300
+        mixed           // any of the above
+    };
+
+    std::uint64_t seed = 1;
+    unsigned depth = 4;           // the deepest nesting of objects and arrays
+    unsigned width = 8;           // members per object
+    unsigned length = 8;          // elements per array
+    double container_ratio = 0.25; // chance that a value above the deepest level is an object or array
+    double string_ratio = 0.5;    // chance that any other value is a string rather than a number, bool or null
+    unsigned string_length = 16;  // average characters per string, keys are a little shorter
+    double escape_ratio = 0.05;   // chance that a character needs an escape or is multi-byte
+    number_distribution numbers = mixed;
+
+    // when not 0 the output is an array of documents that stops once it is at least this many bytes
+    std::uint64_t size = 0;
+};
+
+namespace detail {
+template<typename OStream>
+class generator {
+private:
+    OStream& out;
+    const generator_options& opt;
+    std::uint64_t state;
+    std::uint64_t written = 0;
+
+    // splitmix64
+    std::uint64_t next() JSONPP_NOEXCEPT {
+        std::uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    std::uint64_t below(std::uint64_t limit) JSONPP_NOEXCEPT {
+        return limit == 0 ? 0 : next() % limit;
+    }
+
+    bool chance(double probability) JSONPP_NOEXCEPT {
+        return static_cast<double>(next() >> 11) / 9007199254740992.0 < probability;
+    }
+
+    void emit(const char* str, std::size_t size) {
+        detail::write(out, str, size);
+        written += size;
+    }
+
+    template<std::size_t N>
+    void emit(const char (&str)[N]) {
+        emit(str, N - 1);
+    }
+
+    void emit(char ch) {
+        out.put(ch);
+        ++written;
+    }
+
+    void digits(std::uint64_t value, unsigned count = 0) {
+        char buffer[24];
+        char* last = buffer + sizeof(buffer);
+        char* first = last;
+        do {
+            *--first = static_cast<char>('0' + value % 10);
+            value /= 10;
+        }
+        while(value != 0 || static_cast<unsigned>(last - first) < count);
+        emit(first, static_cast<std::size_t>(last - first));
+    }
+
+    void number() {
+        std::uint64_t kind = opt.numbers;
+        if(opt.numbers == generator_options::mixed) {
+            kind = below(generator_options::mixed);
+        }
+        switch(kind) {
+        case generator_options::small_integers:
+            if(below(4) == 0) {
+                emit('-');
+            }
+            digits(below(1000));
+            break;
+        case generator_options::large_integers: {
+            if(below(2) == 0) {
+                emit('-');
+            }
+            std::uint64_t limit = 1;
+            for(auto count = 1 + below(19); count != 0; --count) {
+                limit *= 10;
+            }
+            digits(below(limit));
+            break;
+        }
+        case generator_options::decimals:
+            if(below(4) == 0) {
+                emit('-');
+            }
+            digits(below(100000));
+            emit('.');
+            digits(below(1000000), 6);
+            break;
+        default:
+            digits(1 + below(9));
+            emit('.');
+            digits(below(1000), 3);
+            emit(below(2) == 0 ? "e-" : "e+");
+            digits(below(301));
+            break;
+        }
+    }
+
+    void string() {
+        static const char* const escapes[] = { "\\n", "\\t", "\\\"", "\\\\", "\\/", "\\u00e9", "\\ud83d\\ude00", "\xc3\xa9", "\xe3\x81\x82" };
+        static const char letters[] = "abcdefghijklmnopqrstuvwxyz ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+        emit('"');
+        for(auto count = opt.string_length / 2 + below(opt.string_length + 1); count != 0; --count) {
+            if(opt.escape_ratio > 0 && chance(opt.escape_ratio)) {
+                auto escape = escapes[below(sizeof(escapes) / sizeof(escapes[0]))];
+                emit(escape, std::char_traits<char>::length(escape));
+            }
+            else {
+                emit(letters[below(sizeof(letters) - 1)]);
+            }
+        }
+        emit('"');
+    }
+
+    void scalar() {
+        if(chance(opt.string_ratio)) {
+            string();
+            return;
+        }
+
+        switch(below(8)) {
+        case 0:
+            emit("true");
+            break;
+        case 1:
+            emit("false");
+            break;
+        case 2:
+            emit("null");
+            break;
+        default:
+            number();
+            break;
+        }
+    }
+
+    void object(unsigned level) {
+        emit('{');
+        for(unsigned i = 0; i < opt.width; ++i) {
+            if(i != 0) {
+                emit(',');
+            }
+            // the index keeps the keys unique
+            emit('"');
+            for(auto count = opt.string_length / 2 + below(opt.string_length / 2 + 1); count != 0; --count) {
+                emit(static_cast<char>('a' + below(26)));
+            }
+            digits(i);
+            emit("\":");
+            element(level + 1);
+        }
+        emit('}');
+    }
+
+    void array(unsigned level) {
+        emit('[');
+        for(unsigned i = 0; i < opt.length; ++i) {
+            if(i != 0) {
+                emit(',');
+            }
+            element(level + 1);
+        }
+        emit(']');
+    }
+
+    void element(unsigned level) {
+        if(level == 0 && opt.depth != 0) {
+            object(level);
+        }
+        else if(level < opt.depth && chance(opt.container_ratio)) {
+            if(below(2) == 0) {
+                object(level);
+            }
+            else {
+                array(level);
+            }
+        }
+        else {
+            scalar();
+        }
+    }
+public:
+    generator(OStream& out, const generator_options& opt) JSONPP_NOEXCEPT: out(out), opt(opt), state(opt.seed) {}
+
+    std::uint64_t operator()() {
+        if(opt.size == 0) {
+            element(0);
+            return written;
+        }
+
+        emit('[');
+        element(0);
+        while(written < opt.size) {
+            emit(',');
+            element(0);
+        }
+        emit(']');
+        return written;
+    }
+};
+} // detail
+
+// writes a pseudo-random JSON document shaped by opt to a sink and returns the number of bytes written
+// the document is produced as it is written so its size is only limited by the sink
+template<typename OStream>
+inline std::uint64_t generate(OStream& out, const generator_options& opt = {}) {
+    return detail::generator<OStream>(out, opt)();
+}
+
+inline std::string generate_string(const generator_options& opt = {}) {
+    string_sink out;
+    generate(out, opt);
+    return std::move(out.str());
+}
+} // json
+
+#endif // JSONPP_GENERATOR_HPP
@@ -0,0 +1,381 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef JSONPP_MSGPACK_HPP
+#define JSONPP_MSGPACK_HPP
+
+#include "detail/binary.hpp"
+#include "sink.hpp"
+#include <vector>
+#include <cassert>
+#include <stdexcept>
+
+namespace json {
+namespace detail {
+// the 32 bit form of every size prefix directly follows the 16 bit one
+// code8 is zero for containers since they have no 8 bit form
+template<typename OStream>
+inline void write_msgpack_size(OStream& out, std::size_t size, unsigned fix, std::size_t fix_limit, unsigned code8, unsigned code16) {
+    if(size < fix_limit) {
+        write_byte(out, fix | static_cast<unsigned>(size));
+    }
+    else if(code8 != 0 && size <= 0xFF) {
+        write_byte(out, code8);
+        write_big_endian(out, size, 1);
+    }
+    else if(size <= 0xFFFF) {
+        write_byte(out, code16);
+        write_big_endian(out, size, 2);
+    }
+    else if(size <= 0xFFFFFFFF) {
+        write_byte(out, code16 + 1);
+        write_big_endian(out, size, 4);
+    }
+    else {
+        throw std::length_error("value too large for MessagePack");
+    }
+}
+
+template<typename OStream>
+inline void write_msgpack_string(OStream& out, const std::string& str) {
+    write_msgpack_size(out, str.size(), 0xa0, 32, 0xd9, 0xda);
+    out.write(str.data(), str.size());
+}
+
+template<typename OStream>
+inline void write_msgpack_number(OStream& out, const value& v) {
+    auto n = classify_number(v);
+    if(n.kind == binary_number::positive) {
+        if(n.magnitude < 0x80) {
+            write_byte(out, static_cast<unsigned>(n.magnitude));
+        }
+        else if(n.magnitude <= 0xFF) {
+            write_byte(out, 0xcc);
+            write_big_endian(out, n.magnitude, 1);
+        }
+        else if(n.magnitude <= 0xFFFF) {
+            write_byte(out, 0xcd);
+            write_big_endian(out, n.magnitude, 2);
+        }
+        else if(n.magnitude <= 0xFFFFFFFF) {
+            write_byte(out, 0xce);
+            write_big_endian(out, n.magnitude, 4);
+        }
+        else {
+            write_byte(out, 0xcf);
+            write_big_endian(out, n.magnitude, 8);
+        }
+    }
+    else if(n.kind == binary_number::negative) {
+        // magnitude is -(n + 1) so the limits are one less than the type's range
+        if(n.magnitude < 32) {
+            write_byte(out, 0xe0 | static_cast<unsigned>(31 - n.magnitude));
+        }
+        else if(n.magnitude < 0x80) {
+            write_byte(out, 0xd0);
+            write_big_endian(out, ~n.magnitude, 1);
+        }
+        else if(n.magnitude < 0x8000) {
+            write_byte(out, 0xd1);
+            write_big_endian(out, ~n.magnitude, 2);
+        }
+        else if(n.magnitude < 0x80000000) {
+            write_byte(out, 0xd2);
+            write_big_endian(out, ~n.magnitude, 4);
+        }
+        else {
+            write_byte(out, 0xd3);
+            write_big_endian(out, ~n.magnitude, 8);
+        }
+    }
+    else {
+        write_float(out, n.number, 0xca, 0xcb);
+    }
+}
+
+template<typename OStream>
+inline void write_msgpack(OStream& out, const value& v) {
+    if(v.is<null>()) {
+        write_byte(out, 0xc0);
+    }
+    else if(v.is<bool>()) {
+        write_byte(out, v.as<bool>() ? 0xc3 : 0xc2);
+    }
+    else if(v.is<double>()) {
+        write_msgpack_number(out, v);
+    }
+    else if(v.is<std::string>()) {
+        write_msgpack_string(out, v.get<std::string>());
+    }
+    else if(v.is<array>()) {
+        auto&& arr = v.get<array>();
+        write_msgpack_size(out, arr.size(), 0x90, 16, 0, 0xdc);
+        for(auto&& elem : arr) {
+            write_msgpack(out, elem);
+        }
+    }
+    else if(v.is<object>()) {
+        auto&& obj = v.get<object>();
+        write_msgpack_size(out, obj.size(), 0x80, 16, 0, 0xde);
+        for(auto&& member : obj) {
+            write_msgpack_string(out, member.first);
+            write_msgpack(out, member.second);
+        }
+    }
+}
+
+inline std::int64_t sign_extend(std::uint64_t n, std::size_t size) JSONPP_NOEXCEPT {
+    unsigned shift = static_cast<unsigned>(64 - size * 8);
+    return static_cast<std::int64_t>(n << shift) >> shift;
+}
+
+inline value msgpack_signed(std::int64_t n) {
+    if(n >= 0) {
+        return integer_value(static_cast<std::uint64_t>(n));
+    }
+    return negative_integer_value(static_cast<std::uint64_t>(-(n + 1)));
+}
+
+inline bool msgpack_string_size(unsigned code, byte_reader& in, std::uint64_t& size) {
+    if((code & 0xe0) == 0xa0) {
+        size = code & 0x1f;
+    }
+    else if(code == 0xd9 || code == 0xc4) {
+        size = in.big_endian(1);
+    }
+    else if(code == 0xda || code == 0xc5) {
+        size = in.big_endian(2);
+    }
+    else if(code == 0xdb || code == 0xc6) {
+        size = in.big_endian(4);
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+inline void read_msgpack(byte_reader& in, value& v) {
+    unsigned code = in.byte();
+    std::uint64_t size = 0;
+
+    if(code < 0x80) {
+        v = static_cast<double>(code);
+    }
+    else if(code >= 0xe0) {
+        v = static_cast<double>(static_cast<int>(code) - 0x100);
+    }
+    else if(msgpack_string_size(code, in, size)) {
+        // bin is read as a string since JSON has nothing closer
+        std::string str;
+        in.append(str, size);
+        v = std::move(str);
+    }
+    else if((code & 0xf0) == 0x90 || code == 0xdc || code == 0xdd) {
+        size = code == 0xdc ? in.big_endian(2) : code == 0xdd ? in.big_endian(4) : code & 0x0f;
+        in.enter();
+        array arr;
+        arr.resize(in.count(size));
+        for(auto&& elem : arr) {
+            read_msgpack(in, elem);
+        }
+        in.leave();
+        v = std::move(arr);
+    }
+    else if((code & 0xf0) == 0x80 || code == 0xde || code == 0xdf) {
+        size = code == 0xde ? in.big_endian(2) : code == 0xdf ? in.big_endian(4) : code & 0x0f;
+        in.enter();
+        object obj;
+        std::string key;
+        for(std::size_t i = in.count(size); i != 0; --i) {
+            std::uint64_t key_size = 0;
+            if(!msgpack_string_size(in.byte(), in, key_size)) {
+                in.fail("object keys must be strings");
+            }
+            key.clear();
+            in.append(key, key_size);
+            read_msgpack(in, obj[key]);
+        }
+        in.leave();
+        v = std::move(obj);
+    }
+    else {
+        switch(code) {
+        case 0xc0:
+            v = nullptr;
+            break;
+        case 0xc2:
+            v = false;
+            break;
+        case 0xc3:
+            v = true;
+            break;
+        case 0xca:
+            v = static_cast<double>(bits_to_float(static_cast<std::uint32_t>(in.big_endian(4))));
+            break;
+        case 0xcb:
+            v = bits_to_double(in.big_endian(8));
+            break;
+        case 0xcc:
+        case 0xcd:
+        case 0xce:
+        case 0xcf:
+            v = integer_value(in.big_endian(std::size_t(1) << (code - 0xcc)));
+            break;
+        case 0xd0:
+        case 0xd1:
+        case 0xd2:
+        case 0xd3: {
+            std::size_t bytes = std::size_t(1) << (code - 0xd0);
+            v = msgpack_signed(sign_extend(in.big_endian(bytes), bytes));
+            break;
+        }
+        default:
+            in.fail("unsupported MessagePack type");
+        }
+    }
+}
+} // detail
+
+namespace msgpack {
+// encodes a value as MessagePack into a sink
+template<typename OStream>
+inline OStream& dump(OStream& out, const value& v) {
+    detail::write_msgpack(out, v);
+    return out;
+}
+
+inline std::string dump_string(const value& v) {
+    string_sink out;
+    detail::write_msgpack(out, v);
+    return std::move(out.str());
+}
+
+inline void parse(const char* data, std::size_t size, value& v, std::size_t max_depth = detail::default_binary_depth) {
+    detail::byte_reader in(data, size, max_depth);
+    detail::read_msgpack(in, v);
+    if(!in.done()) {
+        in.fail("unexpected data after the value");
+    }
+}
+
+inline void parse(const std::string& data, value& v, std::size_t max_depth = detail::default_binary_depth) {
+    parse(data.data(), data.size(), v, max_depth);
+}
+
+// writes MessagePack incrementally to a sink without building a value first
+// MessagePack stores the size of an array or object before its elements,
+// so unlike json::writer the sizes have to be known when they are begun
+template<typename OStream>
+class writer {
+private:
+    struct frame {
+        bool object;
+        std::size_t remaining; // the values still to be written, keys are not counted
+    };
+
+    OStream& out;
+    std::vector<frame> frames;
+    bool has_key = false;
+    bool has_root = false;
+
+    void prepare_value() {
+        if(frames.empty()) {
+            assert(!has_root && "only a single root value can be written");
+            has_root = true;
+            return;
+        }
+
+        auto&& top = frames.back();
+        assert(top.remaining != 0 && "more elements than the size that was begun");
+        if(top.object) {
+            assert(has_key && "object members must begin with a key");
+            has_key = false;
+        }
+        --top.remaining;
+    }
+
+    void end(bool object) {
+        assert(!frames.empty() && frames.back().object == object && "mismatched end of array or object");
+        assert(!has_key && "object key has no value");
+        assert(frames.back().remaining == 0 && "fewer elements than the size that was begun");
+        frames.pop_back();
+    }
+public:
+    writer(OStream& out): out(out) {}
+
+    writer& begin_object(std::size_t size) {
+        prepare_value();
+        detail::write_msgpack_size(out, size, 0x80, 16, 0, 0xde);
+        frames.push_back({ true, size });
+        return *this;
+    }
+
+    writer& end_object() {
+        end(true);
+        return *this;
+    }
+
+    writer& begin_array(std::size_t size) {
+        prepare_value();
+        detail::write_msgpack_size(out, size, 0x90, 16, 0, 0xdc);
+        frames.push_back({ false, size });
+        return *this;
+    }
+
+    writer& end_array() {
+        end(false);
+        return *this;
+    }
+
+    writer& key(const std::string& str) {
+        assert(!frames.empty() && frames.back().object && "keys can only be written inside objects");
+        assert(!has_key && "object key has no value");
+        detail::write_msgpack_string(out, str);
+        has_key = true;
+        return *this;
+    }
+
+    // writes anything that converts to json::value
+    writer& value(const json::value& v) {
+        prepare_value();
+        detail::write_msgpack(out, v);
+        return *this;
+    }
+
+    // whether every array and object that was begun has been ended
+    bool complete() const JSONPP_NOEXCEPT {
+        return has_root && frames.empty();
+    }
+
+    std::size_t depth() const JSONPP_NOEXCEPT {
+        return frames.size();
+    }
+};
+
+template<typename OStream>
+inline writer<OStream> make_writer(OStream& out) {
+    return { out };
+}
+} // msgpack
+} // json
+
+#endif // JSONPP_MSGPACK_HPP
@@ -24,6 +24,9 @@
 
 #include "error.hpp"
 #include "value.hpp"
+#include "pointer.hpp"
+#include "fields.hpp"
+#include "stats.hpp"
 #include <cstring>
 #include <iosfwd>
 
@@ -40,11 +43,28 @@ inline bool is_space(char ch) {
     }
 }
 
+struct parse_options {
+    enum : int {
+        none = 0,
+        lazy_numbers = 1 << 0
+    };
+
+    parse_options() JSONPP_NOEXCEPT {};
+    parse_options(int flags) JSONPP_NOEXCEPT: flags(flags) {}
+
+    int flags = none;
+};
+
+class sequence;
+
 struct parser {
 private:
+    friend class sequence;
     unsigned line = 1;
     unsigned column = 1;
     const char* str;
+    parse_options opt;
+    detail::arena_ref numbers; // the digits kept by lazy_numbers
 
     void skip_white_space() {
         while(*str != '\0' && is_space(*str)) {
@@ -57,6 +77,15 @@ private:
         }
     }
 
+    // skips the comma between two elements, which cannot be followed by the end of the container
+    void skip_comma(char end) {
+        ++str;
+        skip_white_space();
+        if(*str == end) {
+            throw parser_error("extraneous comma spotted", line, column);
+        }
+    }
+
     void parse_null(value& v) {
         static const char null_str[] = "null";
         if(*str == '\0') {
@@ -74,11 +103,25 @@ private:
 
     void parse_number(value& v) {
         static const std::string lookup = "0123456789eE+-.";
+        detail::stats_timer timer(&stats::number_time);
         const char* begin = str;
         if(*begin == '\0') {
             throw parser_error("expected number, received EOF instead", line, column);
         }
 
+        if((opt.flags & opt.lazy_numbers) == opt.lazy_numbers) {
+            // keep the digits around verbatim and convert them on demand
+            const char* end = detail::scan_number(begin);
+            if(end == nullptr) {
+                throw parser_error("number could not be parsed properly", line, column);
+            }
+
+            str = end;
+            column += (end - begin) + 1;
+            v = value(raw_number, numbers.store(begin, static_cast<std::size_t>(end - begin)));
+            return;
+        }
+
         while(lookup.find(*str) != std::string::npos) {
             ++str;
         }
@@ -147,11 +190,12 @@ private:
             }
 
             // get the  low surrogate pair
-            if(*(copy + 1) != '\\' && *(copy + 2) != 'u') {
+            if(copy[0] != '\\' || copy[1] != 'u') {
                 throw parser_error("low surrogate pair expected but not found", line, column);
             }
 
             copy += 2;
+            column += 2;
             int low_surrogate = get_codepoint(copy);
             if(low_surrogate < 0xDC00 || low_surrogate > 0xDFFF) {
                 throw parser_error("low surrogate out of range [\\uDC000, \\uDFFF]", line, column);
@@ -176,12 +220,14 @@ private:
 
     template<typename Value>
     void parse_string(Value& v) {
+        detail::stats_timer timer(&stats::string_time);
         const char* copy = str + 1;
         if(*copy == '\0') {
             throw parser_error("expected string, received EOF instead", line, column);
         }
 
         std::string result;
+        bool escaped = false;
 
         // begin parsing
         while(true) {
@@ -207,6 +253,7 @@ private:
             // at this point *copy == '\\'
             // so increment it to check the next character
             ++copy;
+            escaped = true;
             switch(*copy) {
             case '/':
                 result.push_back('/');
@@ -245,6 +292,10 @@ private:
             }
         }
 
+        if(escaped) {
+            detail::record_escaped_string();
+        }
+
         v = result;
         ++copy;
         str = copy;
@@ -269,6 +320,7 @@ private:
     }
 
     void parse_array(value& v) {
+        detail::stats_depth depth;
         ++str;
         array arr;
         value elem;
@@ -295,16 +347,18 @@ private:
                 }
             }
 
-            arr.push_back(elem);
+            arr.push_back(std::move(elem));
         }
 
-        v = arr;
-        if(*str == ']') {
-            ++str;
+        if(*str != ']') {
+            throw parser_error("expected value, received EOF instead", line, column);
         }
+        ++str;
+        v = std::move(arr);
     }
 
     void parse_object(value& v) {
+        detail::stats_depth depth;
         ++str;
         object obj;
         std::string key;
@@ -328,6 +382,7 @@ private:
                 throw parser_error("expected string as key not found", line, column);
             }
             parse_string(key);
+            detail::record_value(detail::stats_kind::key);
             skip_white_space();
 
             if(*str != ':') {
@@ -341,16 +396,17 @@ private:
                     throw parser_error("missing comma", line, column);
                 }
             }
-            else if(*str == ',') {
-                ++str;
+            else {
+                skip_comma('}');
             }
-            obj.emplace(key, elem);
+            obj.emplace(key, std::move(elem));
         }
 
-        v = obj;
-        if(*str == '}') {
-            ++str;
+        if(*str != '}') {
+            throw parser_error("expected string key, received EOF instead", line, column);
         }
+        ++str;
+        v = std::move(obj);
     }
 
     void parse_value(value& v) {
@@ -360,24 +416,30 @@ private:
         }
 
         if(isdigit(*str) || *str == '+' || *str == '-') {
+            detail::record_value(detail::stats_kind::number);
             parse_number(v);
         }
         else {
             switch(*str) {
             case 'n':
+                detail::record_value(detail::stats_kind::null);
                 parse_null(v);
                 break;
             case '"':
+                detail::record_value(detail::stats_kind::string);
                 parse_string(v);
                 break;
             case 't':
             case 'f':
+                detail::record_value(detail::stats_kind::boolean);
                 parse_bool(v);
                 break;
             case '[':
+                detail::record_value(detail::stats_kind::array);
                 parse_array(v);
                 break;
             case '{':
+                detail::record_value(detail::stats_kind::object);
                 parse_object(v);
                 break;
             default:
@@ -388,29 +450,541 @@ private:
 
         skip_white_space();
     }
+
+    // checks a string the same way parse_string does without keeping it
+    void skip_string() {
+        std::string codepoint;
+        ++str;
+        ++column;
+        while(*str != '"') {
+            if(static_cast<unsigned char>(*str) <= 0x1F) {
+                throw parser_error("invalid characters found in string or string is incomplete", line, column);
+            }
+
+            if(*str == '\\') {
+                ++str;
+                ++column;
+                if(*str == 'u') {
+                    parse_codepoint(str, codepoint);
+                    codepoint.clear();
+                    continue;
+                }
+
+                if(*str == '\0' || std::strchr("/\\\"fnrtb", *str) == nullptr) {
+                    throw parser_error("improper or incomplete escape character found", line, column);
+                }
+            }
+            ++str;
+            ++column;
+        }
+        ++str;
+        ++column;
+    }
+
+    void skip_number() {
+        if((opt.flags & opt.lazy_numbers) == opt.lazy_numbers) {
+            // the digits are not worth keeping in the arena
+            const char* end = detail::scan_number(str);
+            if(end == nullptr) {
+                throw parser_error("number could not be parsed properly", line, column);
+            }
+            column += (end - str) + 1;
+            str = end;
+            return;
+        }
+
+        value v;
+        parse_number(v);
+    }
+
+    void skip_array() {
+        ++str;
+        skip_white_space();
+        while(*str && *str != ']') {
+            skip_value();
+            if(*str != ',') {
+                if(*str != ']') {
+                    throw parser_error("missing comma", line, column);
+                }
+            }
+            else {
+                skip_comma(']');
+            }
+        }
+
+        if(*str != ']') {
+            throw parser_error("expected value, received EOF instead", line, column);
+        }
+        ++str;
+    }
+
+    void skip_object() {
+        ++str;
+        while(true) {
+            skip_white_space();
+            if(*str == '}') {
+                break;
+            }
+
+            if(*str != '"') {
+                throw parser_error("expected string as key not found", line, column);
+            }
+            skip_string();
+            skip_white_space();
+
+            if(*str != ':') {
+                throw parser_error("missing semicolon", line, column);
+            }
+            ++str;
+            skip_value();
+
+            if(*str != ',') {
+                if(*str != '}') {
+                    throw parser_error("missing comma", line, column);
+                }
+            }
+            else {
+                skip_comma('}');
+            }
+        }
+        ++str;
+    }
+
+    // skips over a value without building it, what parse_value rejects is rejected here too
+    void skip_value() {
+        skip_white_space();
+        if(*str == '\0') {
+            throw parser_error("unexpected EOF found", line, column);
+        }
+
+        if(isdigit(*str) || *str == '+' || *str == '-') {
+            skip_number();
+        }
+        else {
+            value scratch;
+            switch(*str) {
+            case 'n':
+                parse_null(scratch);
+                break;
+            case '"':
+                skip_string();
+                break;
+            case 't':
+            case 'f':
+                parse_bool(scratch);
+                break;
+            case '[':
+                skip_array();
+                break;
+            case '{':
+                skip_object();
+                break;
+            default:
+                throw parser_error("unexpected token found", line, column);
+                break;
+            }
+        }
+
+        skip_white_space();
+    }
+
+    template<typename Callback>
+    void extract_value(const std::vector<selector>& selectors, const std::vector<std::size_t>& active,
+                       std::size_t depth, Callback& f) {
+        if(active.empty()) {
+            skip_value();
+            return;
+        }
+
+        std::vector<std::size_t> next;
+        for(auto&& index : active) {
+            if(selectors[index].path().size() == depth) {
+                next.push_back(index);
+            }
+        }
+
+        // a selector ends here so the whole value is needed
+        if(!next.empty()) {
+            value v;
+            parse_value(v);
+            for(auto&& index : active) {
+                if(selectors[index].path().size() != depth) {
+                    selectors[index].collect(v, [&](const value& match) { f(index, value(match)); }, depth);
+                }
+            }
+
+            for(std::size_t i = 0; i + 1 < next.size(); ++i) {
+                f(next[i], value(v));
+            }
+            f(next.back(), std::move(v));
+            return;
+        }
+
+        skip_white_space();
+        if(*str == '[') {
+            ++str;
+            skip_white_space();
+            std::size_t count = 0;
+            while(*str && *str != ']') {
+                next.clear();
+                for(auto&& index : active) {
+                    if(selectors[index].path()[depth].matches(count)) {
+                        next.push_back(index);
+                    }
+                }
+
+                extract_value(selectors, next, depth + 1, f);
+                ++count;
+                if(*str != ',') {
+                    if(*str != ']') {
+                        throw parser_error("missing comma", line, column);
+                    }
+                }
+                else {
+                    skip_comma(']');
+                }
+            }
+
+            if(*str != ']') {
+                throw parser_error("expected value, received EOF instead", line, column);
+            }
+            ++str;
+        }
+        else if(*str == '{') {
+            ++str;
+            std::string key;
+            while(true) {
+                skip_white_space();
+                if(*str == '}') {
+                    break;
+                }
+
+                if(*str != '"') {
+                    throw parser_error("expected string as key not found", line, column);
+                }
+                parse_string(key);
+                skip_white_space();
+
+                if(*str != ':') {
+                    throw parser_error("missing semicolon", line, column);
+                }
+                ++str;
+
+                next.clear();
+                for(auto&& index : active) {
+                    if(selectors[index].path()[depth].matches(key)) {
+                        next.push_back(index);
+                    }
+                }
+
+                extract_value(selectors, next, depth + 1, f);
+                if(*str != ',') {
+                    if(*str != '}') {
+                        throw parser_error("missing comma", line, column);
+                    }
+                }
+                else {
+                    skip_comma('}');
+                }
+            }
+            ++str;
+        }
+        else {
+            // scalars cannot contain what the selectors are looking for
+            skip_value();
+            return;
+        }
+
+        skip_white_space();
+    }
+
+    // parses an object key, pointing into the input when it has no escapes
+    void read_key(std::string& buffer, const char*& key, std::size_t& size) {
+        if(*str != '"') {
+            throw parser_error("expected string as key not found", line, column);
+        }
+
+        const char* end = str + 1;
+        while(*end != '"' && *end != '\\' && static_cast<unsigned char>(*end) > 0x1F) {
+            ++end;
+        }
+
+        if(*end == '"') {
+            key = str + 1;
+            size = end - key;
+            column += size + 2;
+            str = end + 1;
+        }
+        else {
+            parse_string(buffer);
+            key = buffer.data();
+            size = buffer.size();
+        }
+
+        skip_white_space();
+        if(*str != ':') {
+            throw parser_error("missing semicolon", line, column);
+        }
+        ++str;
+    }
+
+    // loops over the members of an object calling f(key, size) with the parser
+    // positioned at the start of each value
+    template<typename Function>
+    void read_object(Function f) {
+        skip_white_space();
+        if(*str != '{') {
+            throw parser_error("expected object not found", line, column);
+        }
+
+        ++str;
+        std::string buffer;
+        const char* key = nullptr;
+        std::size_t size = 0;
+        while(true) {
+            skip_white_space();
+            if(*str == '}') {
+                break;
+            }
+
+            read_key(buffer, key, size);
+            f(key, size);
+            if(*str != ',') {
+                if(*str != '}') {
+                    throw parser_error("missing comma", line, column);
+                }
+            }
+            else {
+                skip_comma('}');
+            }
+        }
+        ++str;
+        skip_white_space();
+    }
+
+    struct field_reader {
+        parser& p;
+        int target;
+        int current;
+
+        template<typename T>
+        void operator()(const field_name&, T& member) {
+            if(current++ == target) {
+                p.read_value(member);
+            }
+        }
+    };
+
+    void read_value(value& v) {
+        parse_value(v);
+    }
+
+    void read_value(std::string& s) {
+        skip_white_space();
+        if(*str != '"') {
+            throw parser_error("expected string not found", line, column);
+        }
+        parse_string(s);
+        skip_white_space();
+    }
+
+    void read_value(bool& b) {
+        skip_white_space();
+        if(std::strncmp(str, "true", 4) == 0) {
+            b = true;
+            str += 4;
+            column += 4;
+        }
+        else if(std::strncmp(str, "false", 5) == 0) {
+            b = false;
+            str += 5;
+            column += 5;
+        }
+        else {
+            throw parser_error("expected boolean not found", line, column);
+        }
+        skip_white_space();
+    }
+
+    template<typename T, EnableIf<is_number<T>> = 0>
+    void read_value(T& t) {
+        skip_white_space();
+        const char* end = detail::scan_number(str);
+        if(end == nullptr) {
+            throw parser_error("expected number not found", line, column);
+        }
+
+        t = detail::from_digits<T>(std::string(str, end));
+        column += end - str;
+        str = end;
+        skip_white_space();
+    }
+
+    template<typename T, EnableIf<is_array<T>, Not<std::is_array<T>>> = 0>
+    void read_value(T& t) {
+        skip_white_space();
+        if(*str != '[') {
+            throw parser_error("expected array not found", line, column);
+        }
+
+        ++str;
+        t.clear();
+        skip_white_space();
+        while(*str && *str != ']') {
+            t.emplace_back();
+            read_value(t.back());
+            if(*str != ',') {
+                if(*str != ']') {
+                    throw parser_error("missing comma", line, column);
+                }
+            }
+            else {
+                skip_comma(']');
+            }
+        }
+
+        if(*str != ']') {
+            throw parser_error("expected value, received EOF instead", line, column);
+        }
+        ++str;
+        skip_white_space();
+    }
+
+    template<typename T, EnableIf<is_object<T>, std::is_same<typename T::key_type, std::string>> = 0>
+    void read_value(T& t) {
+        t.clear();
+        read_object([this, &t](const char* key, std::size_t size) {
+            read_value(t[std::string(key, size)]);
+        });
+    }
+
+    template<typename T, EnableIf<has_fields<T>> = 0>
+    void read_value(T& t) {
+        static const detail::field_table table(t);
+        read_object([this, &t](const char* key, std::size_t size) {
+            int index = table.find(key, size);
+            if(index == -1) {
+                skip_value();
+            }
+            else {
+                jsonpp_fields(t, field_reader{ *this, index, 0 });
+            }
+        });
+    }
 public:
-    parser(const char* str) JSONPP_NOEXCEPT: str(str) {}
+    parser(const char* str, parse_options opt = {}) JSONPP_NOEXCEPT: str(str), opt(opt) {}
+
+    JSONPP_DECL void parse(value& v);
+
+    // parses the next of several values concatenated in the string and returns false once
+    // only white space is left, values may be separated by white space, by the record
+    // separator (0x1E) of RFC 7464 or by nothing at all
+    bool next(value& v) {
+        while(*str == 0x1E || is_space(*str)) {
+            if(*str == 0x1E) {
+                ++str;
+                ++column;
+            }
+            skip_white_space();
+        }
 
-    void parse(value& v) {
+        if(*str == '\0') {
+            return false;
+        }
+
+        // each document gets an arena of its own so it does not keep the others alive
+        numbers.reset();
+        detail::stats_session session(&detail::stats_state::parse);
+        const char* first = str;
         parse_value(v);
+        session.bytes(static_cast<std::size_t>(str - first));
+        return true;
+    }
+
+    // parses directly into a type without building a value
+    // members of JSONPP_FIELDS types that are missing from the input are left untouched
+    // and keys that do not name a member are skipped
+    template<typename T, DisableIf<is_value<T>> = 0>
+    void parse(T& t) {
+        detail::stats_session session(&detail::stats_state::parse);
+        const char* first = str;
+        read_value(t);
+        if(*str != '\0') {
+            throw parser_error("unexpected token found", line, column);
+        }
+        session.bytes(static_cast<std::size_t>(str - first));
+    }
+
+    // parses only the values matched by the selectors and skips the rest
+    // f is called as f(selector_index, value&&) in document order
+    template<typename Callback>
+    void extract(const std::vector<selector>& selectors, Callback&& f) {
+        std::vector<std::size_t> active(selectors.size());
+        for(std::size_t i = 0; i < active.size(); ++i) {
+            active[i] = i;
+        }
+
+        extract_value(selectors, active, 0, f);
         if(*str != '\0') {
             throw parser_error("unexpected token found", line, column);
         }
     }
 };
 
-inline void parse(const std::string& str, value& v) {
-    parser js(str.c_str());
+JSONPP_DECL void parse(const std::string& str, value& v, parse_options opt = {});
+
+#if defined(JSONPP_DEFINITIONS)
+JSONPP_DECL void parser::parse(value& v) {
+    detail::stats_session session(&detail::stats_state::parse);
+    const char* first = str;
+    parse_value(v);
+    if(*str != '\0') {
+        throw parser_error("unexpected token found", line, column);
+    }
+    session.bytes(static_cast<std::size_t>(str - first));
+}
+
+JSONPP_DECL void parse(const std::string& str, value& v, parse_options opt) {
+    parser js(str.c_str(), opt);
     js.parse(v);
 }
+#endif
+
+template<typename T, DisableIf<is_value<T>> = 0>
+inline void parse(const std::string& str, T& t, parse_options opt = {}) {
+    parser js(str.c_str(), opt);
+    js.parse(t);
+}
+
+// returns one value per selector, holding the match or null if nothing matched
+// selectors that can match more than once produce an array of every match
+inline std::vector<value> extract(const std::string& str, const std::vector<selector>& selectors, parse_options opt = {}) {
+    std::vector<value> result(selectors.size());
+    for(std::size_t i = 0; i < selectors.size(); ++i) {
+        if(selectors[i].is_multiple()) {
+            result[i] = array{};
+        }
+    }
+
+    parser js(str.c_str(), opt);
+    js.extract(selectors, [&result, &selectors](std::size_t index, value&& v) {
+        if(selectors[index].is_multiple()) {
+            result[index].get<array>().push_back(std::move(v));
+        }
+        else {
+            result[index] = std::move(v);
+        }
+    });
+    return result;
+}
 
 template<typename IStream, DisableIf<is_string<IStream>> = 0>
-inline void parse(IStream& in, value& v) {
+inline void parse(IStream& in, value& v, parse_options opt = {}) {
     static_assert(std::is_base_of<std::istream, IStream>::value, "Input stream passed must inherit from std::istream");
     if(in) {
         std::ostringstream ss;
         ss << in.rdbuf();
-        parse(ss.str(), v);
+        parse(ss.str(), v, opt);
     }
 }
 } // json
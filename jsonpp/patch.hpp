@@ -0,0 +1,508 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef JSONPP_PATCH_HPP
+#define JSONPP_PATCH_HPP
+
+#include "error.hpp"
+#include "pointer.hpp"
+#include <algorithm>
+
+namespace json {
+namespace detail {
+// applies the operations of a JSON Patch in place and records how to undo them
+// values are moved around rather than copied so an operation costs about as much
+// as resolving its paths, only copy and test look at whole subtrees
+class patcher {
+private:
+    using path_type = std::vector<pointer::token>;
+
+    enum class undo_kind {
+        erase,         // remove what is at path
+        assign,        // put old back at path
+        insert,        // insert old at path
+        insert_carried // insert what the previous undo step removed
+    };
+
+    struct undo {
+        undo_kind kind;
+        path_type path;
+        value old;
+    };
+
+    value& root;
+    std::vector<undo> log;
+    std::size_t operation = 0;
+
+    [[noreturn]] void fail(const std::string& str) const {
+        throw patch_error(str, operation);
+    }
+
+    value* resolve(const path_type& path, std::size_t count) {
+        value* current = &root;
+        for(std::size_t i = 0; i < count && current != nullptr; ++i) {
+            current = resolve_token(*current, path[i]);
+        }
+        return current;
+    }
+
+    value& parent(const path_type& path) {
+        auto result = resolve(path, path.size() - 1);
+        if(result == nullptr || (!result->is<array>() && !result->is<object>())) {
+            fail("parent of the path does not exist or is not a container");
+        }
+        return *result;
+    }
+
+    value* target(const path_type& path) {
+        return resolve(path, path.size());
+    }
+
+    // inserts v at path, the last token is rewritten to the index used for arrays
+    void insert(path_type& path, value&& v, bool log_it) {
+        if(path.empty()) {
+            if(log_it) {
+                log.push_back({ undo_kind::assign, path, std::move(root) });
+            }
+            root = std::move(v);
+            return;
+        }
+
+        auto&& container = parent(path);
+        auto&& last = path.back();
+        if(auto arr = container.get_if<array>()) {
+            auto index = last.key == "-" ? arr->size() : last.index;
+            if(index > arr->size()) {
+                fail("array index out of range");
+            }
+            arr->insert(arr->begin() + index, std::move(v));
+            last = { std::to_string(index), index };
+            if(log_it) {
+                log.push_back({ undo_kind::erase, path, value() });
+            }
+            return;
+        }
+
+        auto&& obj = container.get<object>();
+        auto it = obj.find(last.key);
+        if(it == obj.end()) {
+            obj.emplace(last.key, std::move(v));
+            if(log_it) {
+                log.push_back({ undo_kind::erase, path, value() });
+            }
+        }
+        else {
+            if(log_it) {
+                log.push_back({ undo_kind::assign, path, std::move(it->second) });
+            }
+            it->second = std::move(v);
+        }
+    }
+
+    value take(const path_type& path) {
+        if(path.empty()) {
+            fail("the whole document cannot be removed");
+        }
+
+        auto&& container = parent(path);
+        auto&& last = path.back();
+        value result;
+        if(auto arr = container.get_if<array>()) {
+            if(last.index >= arr->size()) {
+                fail("array index out of range");
+            }
+            result = std::move((*arr)[last.index]);
+            arr->erase(arr->begin() + last.index);
+            return result;
+        }
+
+        auto&& obj = container.get<object>();
+        auto it = obj.find(last.key);
+        if(it == obj.end()) {
+            fail("path does not exist");
+        }
+        result = std::move(it->second);
+        obj.erase(it);
+        return result;
+    }
+
+    path_type path_of(const value& op, const char* member) const {
+        auto str = op.find(member);
+        if(str == nullptr || !str->is<std::string>()) {
+            fail(std::string("missing or invalid member \"") + member + '"');
+        }
+
+        try {
+            return pointer(str->get<std::string>()).path();
+        }
+        catch(const std::invalid_argument& e) {
+            fail(e.what());
+        }
+    }
+
+    const value& value_of(const value& op) const {
+        auto result = op.find("value");
+        if(result == nullptr) {
+            fail("missing member \"value\"");
+        }
+        return *result;
+    }
+
+    static bool is_prefix(const path_type& prefix, const path_type& path) {
+        return prefix.size() < path.size() && std::equal(prefix.begin(), prefix.end(), path.begin(),
+               [](const pointer::token& l, const pointer::token& r) { return l.key == r.key; });
+    }
+
+    void apply(const value& op) {
+        if(!op.is<object>()) {
+            fail("operation is not an object");
+        }
+
+        auto name = op.find("op");
+        if(name == nullptr || !name->is<std::string>()) {
+            fail("missing or invalid member \"op\"");
+        }
+
+        auto&& kind = name->get<std::string>();
+        auto path = path_of(op, "path");
+        if(kind == "add") {
+            insert(path, value(value_of(op)), true);
+        }
+        else if(kind == "remove") {
+            auto old = take(path);
+            log.push_back({ undo_kind::insert, std::move(path), std::move(old) });
+        }
+        else if(kind == "replace") {
+            auto current = target(path);
+            if(current == nullptr) {
+                fail("path does not exist");
+            }
+            log.push_back({ undo_kind::assign, std::move(path), std::move(*current) });
+            *current = value_of(op);
+        }
+        else if(kind == "move") {
+            auto from = path_of(op, "from");
+            if(is_prefix(from, path)) {
+                fail("a value cannot be moved into itself");
+            }
+            auto moved = take(from);
+            log.push_back({ undo_kind::insert_carried, std::move(from), value() });
+            try {
+                insert(path, std::move(moved), true);
+            }
+            catch(...) {
+                // the destination was rejected before moved was consumed, so it is put back on its own
+                log.back().kind = undo_kind::insert;
+                log.back().old = std::move(moved);
+                throw;
+            }
+        }
+        else if(kind == "copy") {
+            auto source = target(path_of(op, "from"));
+            if(source == nullptr) {
+                fail("path does not exist");
+            }
+            insert(path, value(*source), true);
+        }
+        else if(kind == "test") {
+            auto current = target(path);
+            if(current == nullptr || *current != value_of(op)) {
+                fail("test failed");
+            }
+        }
+        else {
+            fail("unknown operation \"" + kind + '"');
+        }
+    }
+
+    void rollback() {
+        value carried;
+        for(auto it = log.rbegin(); it != log.rend(); ++it) {
+            switch(it->kind) {
+            case undo_kind::erase:
+                carried = take(it->path);
+                break;
+            case undo_kind::assign: {
+                auto current = target(it->path);
+                carried = std::move(*current);
+                *current = std::move(it->old);
+                break;
+            }
+            case undo_kind::insert:
+                insert(it->path, std::move(it->old), false);
+                break;
+            case undo_kind::insert_carried:
+                insert(it->path, std::move(carried), false);
+                break;
+            }
+        }
+        log.clear();
+    }
+public:
+    explicit patcher(value& root) JSONPP_NOEXCEPT: root(root) {}
+
+    void apply_all(const value& patch) {
+        if(!patch.is<array>()) {
+            fail("patch is not an array");
+        }
+
+        try {
+            for(auto&& op : patch.get<array>()) {
+                apply(op);
+                ++operation;
+            }
+        }
+        catch(...) {
+            rollback();
+            throw;
+        }
+    }
+};
+
+// computes a JSON Patch that turns one value into another
+// identical subtrees are pruned by comparing hashes, objects are merged by key and arrays
+// are aligned with a longest common subsequence after trimming the common prefix and suffix
+// with JSONPP_MEMOIZE_HASH every subtree is hashed once, so documents with localised changes
+// are diffed in about linear time, otherwise each level of nesting hashes its subtree again
+class differ {
+private:
+    // the largest table used for the longest common subsequence of two arrays
+    // larger differences fall back to pairing the elements by position
+    static const std::size_t max_table_size = 1 << 20;
+
+    array ops;
+
+    static std::string append(const std::string& path, const std::string& key) {
+        std::string result = path;
+        result.reserve(path.size() + key.size() + 1);
+        result.push_back('/');
+        for(auto&& ch : key) {
+            if(ch == '~') {
+                result += "~0";
+            }
+            else if(ch == '/') {
+                result += "~1";
+            }
+            else {
+                result.push_back(ch);
+            }
+        }
+        return result;
+    }
+
+    static std::string append(const std::string& path, std::size_t index) {
+        return path + '/' + std::to_string(index);
+    }
+
+    static bool same(const value& lhs, const value& rhs) {
+        return lhs.hash(true) == rhs.hash(true) && lhs == rhs;
+    }
+
+    void add(const std::string& path, const value& v) {
+        ops.push_back(object{ { "op", "add" }, { "path", path }, { "value", v } });
+    }
+
+    void remove(const std::string& path) {
+        ops.push_back(object{ { "op", "remove" }, { "path", path } });
+    }
+
+    void replace(const std::string& path, const value& v) {
+        ops.push_back(object{ { "op", "replace" }, { "path", path }, { "value", v } });
+    }
+
+    void diff_objects(const std::string& path, const object& lhs, const object& rhs) {
+        auto left = lhs.begin();
+        auto right = rhs.begin();
+        while(left != lhs.end() || right != rhs.end()) {
+            if(right == rhs.end() || (left != lhs.end() && left->first < right->first)) {
+                remove(append(path, left->first));
+                ++left;
+            }
+            else if(left == lhs.end() || right->first < left->first) {
+                add(append(path, right->first), right->second);
+                ++right;
+            }
+            else {
+                diff(append(path, left->first), left->second, right->second);
+                ++left;
+                ++right;
+            }
+        }
+    }
+
+    // turns lhs[first, first + removed) into rhs[second, second + added) at index
+    // elements are paired by position and diffed, the rest is removed or added
+    // returns the index after the run in the patched array
+    std::size_t diff_run(const std::string& path, std::size_t index, const array& lhs, std::size_t first, std::size_t removed,
+                         const array& rhs, std::size_t second, std::size_t added) {
+        std::size_t paired = std::min(removed, added);
+        for(std::size_t i = 0; i < paired; ++i, ++index) {
+            diff(append(path, index), lhs[first + i], rhs[second + i]);
+        }
+
+        for(std::size_t i = paired; i < removed; ++i) {
+            remove(append(path, index));
+        }
+
+        for(std::size_t i = paired; i < added; ++i, ++index) {
+            add(append(path, index), rhs[second + i]);
+        }
+        return index;
+    }
+
+    void diff_arrays(const std::string& path, const array& lhs, const array& rhs) {
+        std::size_t prefix = 0;
+        std::size_t common = std::min(lhs.size(), rhs.size());
+        while(prefix < common && same(lhs[prefix], rhs[prefix])) {
+            ++prefix;
+        }
+
+        std::size_t suffix = 0;
+        while(suffix < common - prefix && same(lhs[lhs.size() - suffix - 1], rhs[rhs.size() - suffix - 1])) {
+            ++suffix;
+        }
+
+        std::size_t rows = lhs.size() - prefix - suffix;
+        std::size_t columns = rhs.size() - prefix - suffix;
+        if(rows == 0 || columns == 0 || (rows + 1) * (columns + 1) > max_table_size) {
+            diff_run(path, prefix, lhs, prefix, rows, rhs, prefix, columns);
+            return;
+        }
+
+        // the table compares every pair of elements so each one is hashed up front
+        std::vector<std::uint64_t> left(rows);
+        std::vector<std::uint64_t> right(columns);
+        for(std::size_t i = 0; i < rows; ++i) {
+            left[i] = lhs[prefix + i].hash(true);
+        }
+        for(std::size_t j = 0; j < columns; ++j) {
+            right[j] = rhs[prefix + j].hash(true);
+        }
+
+        auto matches = [&](std::size_t i, std::size_t j) {
+            return left[i] == right[j] && lhs[prefix + i] == rhs[prefix + j];
+        };
+
+        // lengths of the longest common subsequence of the suffixes starting at i and j
+        std::vector<std::uint32_t> table((rows + 1) * (columns + 1), 0);
+        auto at = [&](std::size_t i, std::size_t j) -> std::uint32_t& { return table[i * (columns + 1) + j]; };
+        for(std::size_t i = rows; i-- != 0;) {
+            for(std::size_t j = columns; j-- != 0;) {
+                if(matches(i, j)) {
+                    at(i, j) = at(i + 1, j + 1) + 1;
+                }
+                else {
+                    at(i, j) = std::max(at(i + 1, j), at(i, j + 1));
+                }
+            }
+        }
+
+        // walk the table and emit the runs between matched elements
+        std::size_t index = prefix;
+        std::size_t i = 0;
+        std::size_t j = 0;
+        while(i < rows || j < columns) {
+            std::size_t run_i = i;
+            std::size_t run_j = j;
+            while(i < rows && j < columns && !matches(i, j)) {
+                if(at(i + 1, j) >= at(i, j + 1)) {
+                    ++i;
+                }
+                else {
+                    ++j;
+                }
+            }
+
+            if(i == rows || j == columns) {
+                i = rows;
+                j = columns;
+            }
+
+            index = diff_run(path, index, lhs, prefix + run_i, i - run_i, rhs, prefix + run_j, j - run_j);
+            if(i < rows) {
+                // a matched element stays where it is
+                ++i;
+                ++j;
+                ++index;
+            }
+        }
+    }
+
+    void diff(const std::string& path, const value& lhs, const value& rhs) {
+        if(same(lhs, rhs)) {
+            return;
+        }
+
+        if(lhs.is<object>() && rhs.is<object>()) {
+            diff_objects(path, lhs.get<object>(), rhs.get<object>());
+        }
+        else if(lhs.is<array>() && rhs.is<array>()) {
+            diff_arrays(path, lhs.get<array>(), rhs.get<array>());
+        }
+        else {
+            replace(path, rhs);
+        }
+    }
+public:
+    value operator()(const value& lhs, const value& rhs) {
+        ops.clear();
+        diff(std::string(), lhs, rhs);
+        return std::move(ops);
+    }
+};
+} // detail
+
+// returns a JSON Patch that turns from into to when applied with apply_patch
+// with JSONPP_MEMOIZE_HASH the hashes of both values are memoized, see value::hash
+inline value diff(const value& from, const value& to) {
+    return detail::differ()(from, to);
+}
+
+// applies a JSON Patch (RFC 6902) to a document in place
+// either every operation succeeds or the document is left as it was
+inline void apply_patch(value& doc, const value& patch) {
+    detail::patcher(doc).apply_all(patch);
+}
+
+// applies a JSON Merge Patch (RFC 7396) to a document in place
+inline void apply_merge_patch(value& doc, const value& patch) {
+    if(!patch.is<object>()) {
+        doc = patch;
+        return;
+    }
+
+    if(!doc.is<object>()) {
+        doc = object{};
+    }
+
+    auto&& obj = doc.get<object>();
+    for(auto&& member : patch.get<object>()) {
+        if(member.second.is<null>()) {
+            obj.erase(member.first);
+        }
+        else {
+            apply_merge_patch(obj[member.first], member.second);
+        }
+    }
+}
+} // json
+
+#endif // JSONPP_PATCH_HPP
@@ -0,0 +1,305 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef JSONPP_POINTER_HPP
+#define JSONPP_POINTER_HPP
+
+#include "value.hpp"
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+namespace json {
+namespace detail {
+// array indices in a path must not have leading zeroes
+inline std::size_t array_index(const std::string& key) JSONPP_NOEXCEPT {
+    const auto npos = std::string::npos;
+    if(key.empty() || (key.size() > 1 && key.front() == '0')) {
+        return npos;
+    }
+
+    std::size_t result = 0;
+    for(auto&& ch : key) {
+        if(ch < '0' || ch > '9') {
+            return npos;
+        }
+
+        auto digit = static_cast<std::size_t>(ch - '0');
+        if(result > (npos - digit) / 10) {
+            return npos;
+        }
+        result = result * 10 + digit;
+    }
+    return result;
+}
+} // detail
+
+// a JSON Pointer as specified by RFC 6901
+// the path is split and unescaped once so that it can be resolved repeatedly
+class pointer {
+public:
+    struct token {
+        std::string key;
+        std::size_t index; // std::string::npos if the token is not an array index
+    };
+private:
+    std::vector<token> tokens;
+
+public:
+    pointer() = default;
+
+    pointer(const std::string& path) {
+        if(path.empty()) {
+            return;
+        }
+
+        if(path.front() != '/') {
+            throw std::invalid_argument("JSON pointer must be empty or begin with '/'");
+        }
+
+        std::string key;
+        for(std::size_t i = 1; i <= path.size(); ++i) {
+            if(i == path.size() || path[i] == '/') {
+                auto index = detail::array_index(key);
+                tokens.push_back({ std::move(key), index });
+                key.clear();
+                continue;
+            }
+
+            if(path[i] != '~') {
+                key.push_back(path[i]);
+                continue;
+            }
+
+            // at this point path[i] == '~' so an escape must follow
+            ++i;
+            if(i == path.size() || (path[i] != '0' && path[i] != '1')) {
+                throw std::invalid_argument("invalid escape sequence in JSON pointer");
+            }
+            key.push_back(path[i] == '0' ? '~' : '/');
+        }
+    }
+
+    pointer(const char* path): pointer(std::string(path)) {}
+
+    const std::vector<token>& path() const JSONPP_NOEXCEPT {
+        return tokens;
+    }
+
+    bool empty() const JSONPP_NOEXCEPT {
+        return tokens.empty();
+    }
+
+    std::string to_string() const {
+        std::string result;
+        for(auto&& tok : tokens) {
+            result.push_back('/');
+            for(auto&& ch : tok.key) {
+                if(ch == '~') {
+                    result += "~0";
+                }
+                else if(ch == '/') {
+                    result += "~1";
+                }
+                else {
+                    result.push_back(ch);
+                }
+            }
+        }
+        return result;
+    }
+
+    // resolves the pointer against a document
+    // other document types can be supported by overloading resolve_token
+    template<typename Document>
+    Document* resolve(Document& doc) const {
+        Document* current = &doc;
+        for(auto&& tok : tokens) {
+            current = resolve_token(*current, tok);
+            if(current == nullptr) {
+                return nullptr;
+            }
+        }
+        return current;
+    }
+};
+
+inline value* resolve_token(value& v, const pointer::token& tok) {
+    if(auto arr = v.get_if<array>()) {
+        return tok.index < arr->size() ? &(*arr)[tok.index] : nullptr;
+    }
+    return v.find(tok.key);
+}
+
+inline const value* resolve_token(const value& v, const pointer::token& tok) {
+    if(auto arr = v.get_if<array>()) {
+        return tok.index < arr->size() ? &(*arr)[tok.index] : nullptr;
+    }
+    return v.find(tok.key);
+}
+
+// a path pattern used to pick values out of a document
+// it is either a JSON Pointer or a simple JSONPath expression such as
+// $.statuses[*].user['screen_name'] where * matches any key or index
+class selector {
+public:
+    struct step {
+        pointer::token token;
+        bool wildcard;
+
+        bool matches(const std::string& key) const JSONPP_NOEXCEPT {
+            return wildcard || token.key == key;
+        }
+
+        bool matches(std::size_t index) const JSONPP_NOEXCEPT {
+            return wildcard || token.index == index;
+        }
+    };
+private:
+    std::vector<step> steps;
+    bool multiple = false;
+
+    void add_step(std::string key, bool wildcard) {
+        auto index = wildcard ? std::string::npos : detail::array_index(key);
+        steps.push_back({ { std::move(key), index }, wildcard });
+        multiple = multiple || wildcard;
+    }
+
+    void parse_jsonpath(const std::string& path) {
+        static const std::invalid_argument invalid("invalid JSONPath expression");
+        std::size_t i = 1;
+        while(i < path.size()) {
+            if(path[i] == '.') {
+                ++i;
+                auto last = path.find_first_of(".[", i);
+                if(last == std::string::npos) {
+                    last = path.size();
+                }
+
+                if(last == i) {
+                    throw invalid;
+                }
+
+                std::string key = path.substr(i, last - i);
+                add_step(key, key == "*");
+                i = last;
+            }
+            else if(path[i] == '[') {
+                ++i;
+                if(i == path.size()) {
+                    throw invalid;
+                }
+
+                auto quote = path[i];
+                if(quote == '\'' || quote == '"') {
+                    auto last = path.find(quote, i + 1);
+                    if(last == std::string::npos || last + 1 >= path.size() || path[last + 1] != ']') {
+                        throw invalid;
+                    }
+                    add_step(path.substr(i + 1, last - i - 1), false);
+                    i = last + 2;
+                    continue;
+                }
+
+                auto last = path.find(']', i);
+                if(last == std::string::npos || last == i) {
+                    throw invalid;
+                }
+
+                std::string key = path.substr(i, last - i);
+                bool wildcard = key == "*";
+                if(!wildcard && key.find_first_not_of("0123456789") != std::string::npos) {
+                    throw invalid;
+                }
+                add_step(key, wildcard);
+                i = last + 1;
+            }
+            else {
+                throw invalid;
+            }
+        }
+    }
+
+    template<typename Callback>
+    void collect_from(const value& v, std::size_t depth, Callback& f) const {
+        if(depth == steps.size()) {
+            f(v);
+            return;
+        }
+
+        auto&& current = steps[depth];
+        if(auto arr = v.get_if<array>()) {
+            for(std::size_t i = 0; i < arr->size(); ++i) {
+                if(current.matches(i)) {
+                    collect_from((*arr)[i], depth + 1, f);
+                }
+            }
+        }
+        else if(auto obj = v.get_if<object>()) {
+            if(!current.wildcard) {
+                auto ptr = v.find(current.token.key);
+                if(ptr != nullptr) {
+                    collect_from(*ptr, depth + 1, f);
+                }
+                return;
+            }
+
+            for(auto&& elem : *obj) {
+                collect_from(elem.second, depth + 1, f);
+            }
+        }
+    }
+public:
+    selector(const pointer& p) {
+        for(auto&& tok : p.path()) {
+            steps.push_back({ tok, false });
+        }
+    }
+
+    selector(const std::string& path) {
+        if(!path.empty() && path.front() == '$') {
+            parse_jsonpath(path);
+        }
+        else {
+            *this = selector(pointer(path));
+        }
+    }
+
+    selector(const char* path): selector(std::string(path)) {}
+
+    const std::vector<step>& path() const JSONPP_NOEXCEPT {
+        return steps;
+    }
+
+    // whether the selector can match more than one value
+    bool is_multiple() const JSONPP_NOEXCEPT {
+        return multiple;
+    }
+
+    // calls f with every value matched below the first depth steps of v
+    template<typename Callback>
+    void collect(const value& v, Callback f, std::size_t depth = 0) const {
+        collect_from(v, depth, f);
+    }
+};
+} // json
+
+#endif // JSONPP_POINTER_HPP
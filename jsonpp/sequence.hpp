@@ -0,0 +1,195 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef JSONPP_SEQUENCE_HPP
+#define JSONPP_SEQUENCE_HPP
+
+#include "parser.hpp"
+#include <iterator>
+#include <istream>
+
+namespace json {
+// the values of a buffer holding several concatenated JSON texts, such as
+// newline delimited JSON or an RFC 7464 sequence, parsed one at a time
+// as it is iterated. the parser and the current value are reused between
+// values, so a value has to be moved out to be kept past the next increment
+class sequence {
+private:
+    std::string buffer; // the input when it is owned
+    std::istream* in = nullptr; // read into the buffer one value at a time
+    parser p;
+    value current;
+    bool started = false;
+    bool done = false;
+
+    static bool is_delimiter(int ch) {
+        return ch == 0x1E || ch == '"' || ch == '[' || ch == '{' || is_space(static_cast<char>(ch));
+    }
+
+    // replaces the buffer with the next value of the stream without reading past its end,
+    // so that a stream that stays open yields each value once it is complete
+    // this only finds where the value ends, the parser still checks it
+    bool fill() {
+        using traits = std::istream::traits_type;
+        std::streambuf* sb = in->rdbuf();
+        buffer.clear();
+        int ch = *in && sb != nullptr ? sb->sgetc() : traits::eof();
+
+        // the separators are kept so that the parser counts the lines
+        while(ch != traits::eof() && (ch == 0x1E || is_space(static_cast<char>(ch)))) {
+            buffer.push_back(static_cast<char>(ch));
+            ch = sb->snextc();
+        }
+
+        if(ch == traits::eof()) {
+            in->setstate(std::ios_base::eofbit);
+            p.str = buffer.c_str();
+            return false;
+        }
+
+        if(ch == '"' || ch == '[' || ch == '{') {
+            // strings and containers end with a character of their own
+            std::size_t depth = 0;
+            bool quoted = false;
+            bool escaped = false;
+            do {
+                ch = sb->sbumpc();
+                if(ch == traits::eof()) {
+                    in->setstate(std::ios_base::eofbit);
+                    break;
+                }
+
+                char c = static_cast<char>(ch);
+                buffer.push_back(c);
+                if(escaped) {
+                    escaped = false;
+                }
+                else if(quoted) {
+                    escaped = c == '\\';
+                    quoted = c != '"';
+                }
+                else if(c == '"') {
+                    quoted = true;
+                }
+                else if(c == '[' || c == '{') {
+                    ++depth;
+                }
+                else if(c == ']' || c == '}') {
+                    --depth;
+                }
+            }
+            while(quoted || depth != 0);
+        }
+        else {
+            // anything else runs up to the next delimiter, which has to be peeked at
+            do {
+                buffer.push_back(static_cast<char>(ch));
+                ch = sb->snextc();
+            }
+            while(ch != traits::eof() && !is_delimiter(ch));
+        }
+
+        // the parser carries its line and column over from the previous value
+        p.str = buffer.c_str();
+        return true;
+    }
+
+    void advance() {
+        started = true;
+        done = !p.next(current);
+        while(done && in != nullptr && fill()) {
+            done = !p.next(current);
+        }
+    }
+public:
+    class iterator {
+    private:
+        friend class sequence;
+        sequence* seq = nullptr;
+
+        explicit iterator(sequence* seq) JSONPP_NOEXCEPT: seq(seq) {}
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = value;
+        using difference_type = std::ptrdiff_t;
+        using pointer = value*;
+        using reference = value&;
+
+        iterator() JSONPP_NOEXCEPT = default;
+
+        value& operator*() const JSONPP_NOEXCEPT {
+            assert(seq != nullptr);
+            return seq->current;
+        }
+
+        value* operator->() const JSONPP_NOEXCEPT {
+            assert(seq != nullptr);
+            return &seq->current;
+        }
+
+        iterator& operator++() {
+            assert(seq != nullptr);
+            seq->advance();
+            if(seq->done) {
+                seq = nullptr;
+            }
+            return *this;
+        }
+
+        bool operator==(const iterator& other) const JSONPP_NOEXCEPT {
+            return seq == other.seq;
+        }
+
+        bool operator!=(const iterator& other) const JSONPP_NOEXCEPT {
+            return seq != other.seq;
+        }
+    };
+
+    // reads from a string already in memory that must outlive the sequence
+    explicit sequence(const char* str, parse_options opt = {}) JSONPP_NOEXCEPT: p(str, opt) {}
+
+    // reads from a copy of str
+    explicit sequence(std::string str, parse_options opt = {}): buffer(std::move(str)), p(buffer.c_str(), opt) {}
+
+    // reads the stream one value at a time, reusing the buffer for each of them
+    template<typename IStream, EnableIf<std::is_base_of<std::istream, IStream>> = 0>
+    explicit sequence(IStream& in, parse_options opt = {}): in(&in), p(buffer.c_str(), opt) {}
+
+    // the parser points into the buffer
+    sequence(const sequence&) = delete;
+    sequence& operator=(const sequence&) = delete;
+
+    // parses the first value unless it was already parsed, the sequence can only be iterated once
+    // throws parser_error from here and from iterator::operator++ if a value is malformed
+    iterator begin() {
+        if(!started) {
+            advance();
+        }
+        return done ? iterator() : iterator(this);
+    }
+
+    iterator end() JSONPP_NOEXCEPT {
+        return iterator();
+    }
+};
+} // json
+
+#endif // JSONPP_SEQUENCE_HPP
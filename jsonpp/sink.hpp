@@ -0,0 +1,112 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef JSONPP_SINK_HPP
+#define JSONPP_SINK_HPP
+
+#include "config.hpp"
+#include <string>
+#include <algorithm>
+#include <cstddef>
+
+namespace json {
+// sinks are the output destinations accepted by dump
+// anything with put(char) and write(const char*, std::size_t) works,
+// which includes std::ostream and the types below
+
+// writes into a growable contiguous buffer
+class string_sink {
+private:
+    std::string buffer;
+public:
+    string_sink() = default;
+
+    explicit string_sink(std::size_t capacity) {
+        buffer.reserve(capacity);
+    }
+
+    void put(char ch) {
+        buffer.push_back(ch);
+    }
+
+    void write(const char* str, std::size_t size) {
+        buffer.append(str, size);
+    }
+
+    std::string& str() JSONPP_NOEXCEPT {
+        return buffer;
+    }
+
+    const std::string& str() const JSONPP_NOEXCEPT {
+        return buffer;
+    }
+
+    void clear() JSONPP_NOEXCEPT {
+        buffer.clear();
+    }
+};
+
+// writes through an output iterator
+template<typename OutputIterator>
+class iterator_sink {
+private:
+    OutputIterator it;
+public:
+    iterator_sink(OutputIterator it): it(it) {}
+
+    void put(char ch) {
+        *it = ch;
+        ++it;
+    }
+
+    void write(const char* str, std::size_t size) {
+        it = std::copy(str, str + size, it);
+    }
+
+    OutputIterator base() const {
+        return it;
+    }
+};
+
+template<typename OutputIterator>
+inline iterator_sink<OutputIterator> make_iterator_sink(OutputIterator it) {
+    return { it };
+}
+
+namespace detail {
+template<typename OStream>
+inline void write(OStream& out, const char* str, std::size_t size) {
+    out.write(str, size);
+}
+
+template<typename OStream, std::size_t N>
+inline void write(OStream& out, const char (&str)[N]) {
+    out.write(str, N - 1);
+}
+
+template<typename OStream>
+inline void write(OStream& out, const std::string& str) {
+    out.write(str.data(), str.size());
+}
+} // detail
+} // json
+
+#endif // JSONPP_SINK_HPP
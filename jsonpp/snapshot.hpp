@@ -0,0 +1,468 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef JSONPP_SNAPSHOT_HPP
+#define JSONPP_SNAPSHOT_HPP
+
+#include "value.hpp"
+#include "sink.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+namespace json {
+// a snapshot is a value laid out so it can be read in place, e.g. from a memory mapped file
+//
+// every value is a 16 byte slot: a 32 bit tag, a 32 bit size and a 64 bit payload
+// - numbers store the bits of the double, or the offset of their digits if they were parsed lazily
+// - strings store the offset of their bytes which are followed by a null terminator
+// - arrays store the offset of their element slots
+// - objects store the offset of (key slot, value slot) pairs sorted by key
+// offsets are from the start of the snapshot and everything is little endian
+namespace detail {
+static const char snapshot_magic[8] = { 'j', 's', 'o', 'n', 'p', 'p', 's', 'n' };
+static const std::uint32_t snapshot_version = 1;
+static const std::size_t snapshot_header_size = 16;
+static const std::size_t snapshot_slot_size = 16;
+static const std::uint32_t snapshot_digits = 0x100; // tag flag for lazily parsed numbers
+
+inline void store_little_endian(char* out, std::uint64_t n, std::size_t size) JSONPP_NOEXCEPT {
+    for(std::size_t i = 0; i < size; ++i) {
+        out[i] = static_cast<char>(n & 0xFF);
+        n >>= 8;
+    }
+}
+
+inline std::uint64_t load_little_endian(const char* in, std::size_t size) JSONPP_NOEXCEPT {
+    std::uint64_t result = 0;
+    for(std::size_t i = size; i != 0; --i) {
+        result = (result << 8) | static_cast<unsigned char>(in[i - 1]);
+    }
+    return result;
+}
+
+class snapshot_builder {
+private:
+    std::string buffer;
+
+    std::size_t allocate(std::size_t size) {
+        // keep slots 8 byte aligned so in place reads stay cheap
+        std::size_t offset = (buffer.size() + 7) & ~std::size_t(7);
+        buffer.resize(offset + size);
+        return offset;
+    }
+
+    void store_slot(std::size_t at, std::uint32_t tag, std::uint64_t size, std::uint64_t payload) {
+        if(size > 0xFFFFFFFF) {
+            throw std::length_error("value too large for a snapshot");
+        }
+        store_little_endian(&buffer[at], tag, 4);
+        store_little_endian(&buffer[at + 4], size, 4);
+        store_little_endian(&buffer[at + 8], payload, 8);
+    }
+
+    std::size_t store_bytes(const std::string& str) {
+        std::size_t offset = allocate(str.size() + 1);
+        std::memcpy(&buffer[offset], str.c_str(), str.size() + 1);
+        return offset;
+    }
+
+    void store_string(std::size_t at, const std::string& str) {
+        auto offset = store_bytes(str);
+        store_slot(at, static_cast<std::uint32_t>(type::string), str.size(), offset);
+    }
+
+    void store(std::size_t at, const value& v) {
+        if(v.is<null>()) {
+            store_slot(at, static_cast<std::uint32_t>(type::null), 0, 0);
+        }
+        else if(v.is<bool>()) {
+            store_slot(at, static_cast<std::uint32_t>(type::boolean), 0, v.as<bool>());
+        }
+        else if(v.is<double>()) {
+            // the digits are only kept when they say more than the double does
+            auto digits = v.number_text();
+            double d = v.as<double>();
+            std::uint64_t bits;
+            std::memcpy(&bits, &d, sizeof(bits));
+            store_slot(at, static_cast<std::uint32_t>(type::number), 0, bits);
+            if(digits != dump_string(d, format_options(0, format_options::minify))) {
+                auto offset = store_bytes(digits);
+                store_slot(at, static_cast<std::uint32_t>(type::number) | snapshot_digits, digits.size(), offset);
+            }
+        }
+        else if(v.is<std::string>()) {
+            store_string(at, v.get<std::string>());
+        }
+        else if(v.is<array>()) {
+            auto&& arr = v.get<array>();
+            auto offset = allocate(arr.size() * snapshot_slot_size);
+            store_slot(at, static_cast<std::uint32_t>(type::array), arr.size(), offset);
+            for(auto&& elem : arr) {
+                store(offset, elem);
+                offset += snapshot_slot_size;
+            }
+        }
+        else if(v.is<object>()) {
+            // std::map already orders the keys the way the view searches them
+            auto&& obj = v.get<object>();
+            auto offset = allocate(obj.size() * snapshot_slot_size * 2);
+            store_slot(at, static_cast<std::uint32_t>(type::object), obj.size(), offset);
+            for(auto&& member : obj) {
+                store_string(offset, member.first);
+                store(offset + snapshot_slot_size, member.second);
+                offset += snapshot_slot_size * 2;
+            }
+        }
+    }
+public:
+    std::string build(const value& v) {
+        buffer.assign(snapshot_magic, sizeof(snapshot_magic));
+        buffer.resize(snapshot_header_size + snapshot_slot_size);
+        store_little_endian(&buffer[8], snapshot_version, 4);
+        store(snapshot_header_size, v);
+        return std::move(buffer);
+    }
+};
+
+// checks that the slot at offset and everything it refers to lies inside the snapshot
+// the builder always places contents after the slot that refers to them, so requiring
+// that rules out cycles and bounds the recursion by the size of the snapshot
+inline void check_snapshot_slot(const char* data, std::size_t size, std::size_t offset) {
+    auto tag = static_cast<std::uint32_t>(load_little_endian(data + offset, 4));
+    std::uint64_t length = load_little_endian(data + offset + 4, 4);
+    std::uint64_t target = load_little_endian(data + offset + 8, 8);
+    auto kind = static_cast<type>(tag & 0xFF);
+    bool digits = tag == (static_cast<std::uint32_t>(type::number) | snapshot_digits);
+    if((tag & 0xFF) > static_cast<std::uint32_t>(type::object) || (tag > 0xFF && !digits)) {
+        throw std::invalid_argument("jsonpp snapshot has an unknown slot");
+    }
+
+    if(kind != type::string && kind != type::array && kind != type::object && !digits) {
+        return;
+    }
+
+    if(target < offset + snapshot_slot_size || target > size) {
+        throw std::invalid_argument("jsonpp snapshot is truncated or corrupted");
+    }
+
+    if(kind == type::string || digits) {
+        // the bytes are followed by a null terminator
+        if(length >= size - target || data[target + length] != '\0') {
+            throw std::invalid_argument("jsonpp snapshot is truncated or corrupted");
+        }
+        return;
+    }
+
+    std::uint64_t slots = kind == type::object ? length * 2 : length;
+    if(slots > (size - target) / snapshot_slot_size) {
+        throw std::invalid_argument("jsonpp snapshot is truncated or corrupted");
+    }
+
+    for(std::uint64_t i = 0; i < slots; ++i) {
+        auto at = static_cast<std::size_t>(target + i * snapshot_slot_size);
+        // keys are compared as strings by find
+        if(kind == type::object && i % 2 == 0 && load_little_endian(data + at, 4) != static_cast<std::uint32_t>(type::string)) {
+            throw std::invalid_argument("jsonpp snapshot has an unknown slot");
+        }
+        check_snapshot_slot(data, size, at);
+    }
+}
+} // detail
+
+namespace snapshot {
+inline std::string dump_string(const value& v) {
+    detail::snapshot_builder builder;
+    return builder.build(v);
+}
+
+// the snapshot is built in memory first since slots are filled in after their contents
+template<typename OStream>
+inline OStream& dump(OStream& out, const value& v) {
+    auto result = dump_string(v);
+    out.write(result.data(), result.size());
+    return out;
+}
+} // snapshot
+
+// a read-only view into a snapshot with the accessors of value
+// nothing is parsed or allocated, except by as<std::string> which copies
+// constructing the root view checks the whole layout so a truncated file throws instead of being read past its end
+// the snapshot must outlive the views into it
+class snapshot_view {
+private:
+    const char* data = nullptr;
+    const char* slot = nullptr;
+
+    template<typename T>
+    struct is_generic : And<Not<is_string<T>>, Not<is_bool<T>>, Not<is_number<T>>,
+                            Not<is_null<T>>, Not<std::is_same<T, object>>, Not<std::is_same<T, array>>> {};
+
+    snapshot_view(const char* data, const char* slot) JSONPP_NOEXCEPT: data(data), slot(slot) {}
+
+    static const char* null_slot() JSONPP_NOEXCEPT {
+        static const char slot[detail::snapshot_slot_size] = {};
+        return slot;
+    }
+
+    std::uint32_t tag() const JSONPP_NOEXCEPT {
+        return static_cast<std::uint32_t>(detail::load_little_endian(slot, 4));
+    }
+
+    type kind() const JSONPP_NOEXCEPT {
+        return static_cast<type>(tag() & 0xFF);
+    }
+
+    std::uint64_t payload() const JSONPP_NOEXCEPT {
+        return detail::load_little_endian(slot + 8, 8);
+    }
+
+    const char* target() const JSONPP_NOEXCEPT {
+        return data + payload();
+    }
+
+    snapshot_view child(std::size_t index) const JSONPP_NOEXCEPT {
+        return { data, target() + index * detail::snapshot_slot_size };
+    }
+
+    std::string digits() const {
+        return std::string(target(), size());
+    }
+public:
+    snapshot_view() JSONPP_NOEXCEPT: slot(null_slot()) {}
+
+    // views the root of a snapshot written by snapshot::dump
+    snapshot_view(const char* data, std::size_t size): data(data), slot(data + detail::snapshot_header_size) {
+        if(size < detail::snapshot_header_size + detail::snapshot_slot_size ||
+           std::memcmp(data, detail::snapshot_magic, sizeof(detail::snapshot_magic)) != 0) {
+            throw std::invalid_argument("data is not a jsonpp snapshot");
+        }
+
+        if(detail::load_little_endian(data + 8, 4) != detail::snapshot_version) {
+            throw std::invalid_argument("unsupported jsonpp snapshot version");
+        }
+
+        // the accessors trust the offsets so they are all checked once up front
+        detail::check_snapshot_slot(data, size, detail::snapshot_header_size);
+    }
+
+    explicit snapshot_view(const std::string& str): snapshot_view(str.data(), str.size()) {}
+
+    std::string type_name() const {
+        switch(kind()) {
+        case type::array:
+            return "array";
+        case type::string:
+            return "string";
+        case type::object:
+            return "object";
+        case type::number:
+            return "number";
+        case type::boolean:
+            return "boolean";
+        case type::null:
+            return "null";
+        default:
+            return "unknown";
+        }
+    }
+
+    template<typename T, EnableIf<is_string<T>> = 0>
+    bool is() const JSONPP_NOEXCEPT {
+        return kind() == type::string;
+    }
+
+    template<typename T, EnableIf<is_null<T>> = 0>
+    bool is() const JSONPP_NOEXCEPT {
+        return kind() == type::null;
+    }
+
+    template<typename T, EnableIf<is_number<T>> = 0>
+    bool is() const JSONPP_NOEXCEPT {
+        return kind() == type::number;
+    }
+
+    template<typename T, EnableIf<is_bool<T>> = 0>
+    bool is() const JSONPP_NOEXCEPT {
+        return kind() == type::boolean;
+    }
+
+    template<typename T, EnableIf<std::is_same<T, object>> = 0>
+    bool is() const JSONPP_NOEXCEPT {
+        return kind() == type::object;
+    }
+
+    template<typename T, EnableIf<std::is_same<T, array>> = 0>
+    bool is() const JSONPP_NOEXCEPT {
+        return kind() == type::array;
+    }
+
+    template<typename T, EnableIf<is_generic<T>> = 0>
+    bool is() const JSONPP_NOEXCEPT {
+        return false;
+    }
+
+    template<typename T, EnableIf<std::is_same<T, const char*>> = 0>
+    T as() const JSONPP_NOEXCEPT {
+        assert(is<T>());
+        return target();
+    }
+
+    template<typename T, EnableIf<std::is_same<T, std::string>> = 0>
+    T as() const {
+        assert(is<T>());
+        return std::string(target(), size());
+    }
+
+    template<typename T, EnableIf<is_null<T>> = 0>
+    T as() const JSONPP_NOEXCEPT {
+        assert(is<T>());
+        return {};
+    }
+
+    template<typename T, EnableIf<is_bool<T>> = 0>
+    T as() const JSONPP_NOEXCEPT {
+        assert(is<T>());
+        return payload() != 0;
+    }
+
+    template<typename T, EnableIf<is_number<T>> = 0>
+    T as() const {
+        assert(is<T>());
+        if((tag() & detail::snapshot_digits) != 0) {
+            return detail::from_digits<T>(digits());
+        }
+
+        double d;
+        std::uint64_t bits = payload();
+        std::memcpy(&d, &bits, sizeof(d));
+        return static_cast<T>(d);
+    }
+
+    template<typename T>
+    T as(Identity<T>&& def) const {
+        return is<T>() ? as<T>() : std::forward<T>(def);
+    }
+
+    // the length of a string or the number of elements or members
+    std::size_t size() const JSONPP_NOEXCEPT {
+        return static_cast<std::size_t>(detail::load_little_endian(slot + 4, 4));
+    }
+
+    // the key of the member at index in sorted order
+    const char* key(std::size_t index) const JSONPP_NOEXCEPT {
+        assert(is<object>() && index < size());
+        return child(index * 2).target();
+    }
+
+    // the value of the member at index in sorted order
+    snapshot_view member(std::size_t index) const JSONPP_NOEXCEPT {
+        assert(is<object>() && index < size());
+        return child(index * 2 + 1);
+    }
+
+    // binary searches the sorted keys, returns a null view if there is no such key
+    snapshot_view find(const char* key, std::size_t length) const JSONPP_NOEXCEPT {
+        if(!is<object>()) {
+            return {};
+        }
+
+        std::size_t first = 0;
+        std::size_t last = size();
+        while(first < last) {
+            std::size_t middle = first + (last - first) / 2;
+            auto candidate = child(middle * 2);
+            std::size_t candidate_size = candidate.size();
+            int result = std::memcmp(candidate.target(), key, std::min(candidate_size, length));
+            if(result == 0) {
+                if(candidate_size == length) {
+                    return child(middle * 2 + 1);
+                }
+                result = candidate_size < length ? -1 : 1;
+            }
+
+            if(result < 0) {
+                first = middle + 1;
+            }
+            else {
+                last = middle;
+            }
+        }
+        return {};
+    }
+
+    bool contains(const std::string& key) const JSONPP_NOEXCEPT {
+        return find(key.data(), key.size()).slot != null_slot();
+    }
+
+    snapshot_view operator[](const std::string& key) const JSONPP_NOEXCEPT {
+        return find(key.data(), key.size());
+    }
+
+    snapshot_view operator[](const char* key) const JSONPP_NOEXCEPT {
+        return find(key, std::strlen(key));
+    }
+
+    template<typename T, EnableIf<is_number<T>> = 0>
+    snapshot_view operator[](const T& index) const JSONPP_NOEXCEPT {
+        if(!is<array>() || static_cast<std::size_t>(index) >= size()) {
+            return {};
+        }
+        return child(static_cast<std::size_t>(index));
+    }
+
+    // copies the viewed part of the snapshot into a value
+    value to_value() const {
+        switch(kind()) {
+        case type::string:
+            return as<std::string>();
+        case type::boolean:
+            return as<bool>();
+        case type::number:
+            if((tag() & detail::snapshot_digits) != 0) {
+                return value(raw_number, digits());
+            }
+            return as<double>();
+        case type::array: {
+            array arr;
+            arr.reserve(size());
+            for(std::size_t i = 0; i < size(); ++i) {
+                arr.push_back(child(i).to_value());
+            }
+            return arr;
+        }
+        case type::object: {
+            object obj;
+            for(std::size_t i = 0; i < size(); ++i) {
+                obj.emplace_hint(obj.end(), std::string(key(i), child(i * 2).size()), member(i).to_value());
+            }
+            return obj;
+        }
+        default:
+            return nullptr;
+        }
+    }
+};
+} // json
+
+#endif // JSONPP_SNAPSHOT_HPP
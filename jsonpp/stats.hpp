@@ -0,0 +1,280 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef JSONPP_STATS_HPP
+#define JSONPP_STATS_HPP
+
+#include "config.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace json {
+// what the parses or dumps on a thread did while a stats_scope was alive
+// nothing is collected unless JSONPP_STATS is defined, in which case every
+// field is filled in, otherwise the hooks compile down to nothing
+struct stats {
+    std::uint64_t bytes = 0;           // bytes of JSON read or written
+    std::uint64_t nulls = 0;
+    std::uint64_t booleans = 0;
+    std::uint64_t numbers = 0;
+    std::uint64_t strings = 0;         // not counting keys
+    std::uint64_t keys = 0;
+    std::uint64_t arrays = 0;
+    std::uint64_t objects = 0;
+    std::uint64_t escaped_strings = 0; // strings and keys with at least one escape
+    std::size_t max_depth = 0;
+    std::uint64_t allocations = 0;     // as reported through record_allocation
+    std::uint64_t allocated_bytes = 0;
+    std::chrono::nanoseconds total_time{ 0 };
+    std::chrono::nanoseconds string_time{ 0 }; // reading or escaping strings and keys
+    std::chrono::nanoseconds number_time{ 0 }; // reading or formatting numbers
+
+    std::uint64_t values() const JSONPP_NOEXCEPT {
+        return nulls + booleans + numbers + strings + arrays + objects;
+    }
+};
+
+namespace detail {
+enum class stats_kind {
+    null, boolean, number, string, key, array, object
+};
+
+struct stats_state {
+    stats* parse = nullptr;
+    stats* dump = nullptr;
+    stats* active = nullptr; // the outermost parse or dump running on this thread
+    std::size_t depth = 0;
+};
+
+#if defined(JSONPP_STATS)
+inline stats_state& thread_stats() JSONPP_NOEXCEPT {
+    static thread_local stats_state state;
+    return state;
+}
+
+// brackets one parse or dump, the ones it starts itself are folded into it
+class stats_session {
+private:
+    stats* target = nullptr;
+    std::chrono::steady_clock::time_point start;
+public:
+    explicit stats_session(stats* stats_state::* which) JSONPP_NOEXCEPT {
+        auto& state = thread_stats();
+        if(state.active == nullptr && state.*which != nullptr) {
+            target = state.active = state.*which;
+            state.depth = 0;
+            start = std::chrono::steady_clock::now();
+        }
+    }
+
+    stats_session(const stats_session&) = delete;
+    stats_session& operator=(const stats_session&) = delete;
+
+    ~stats_session() {
+        if(target != nullptr) {
+            target->total_time += std::chrono::steady_clock::now() - start;
+            thread_stats().active = nullptr;
+        }
+    }
+
+    // whether this session is the one collecting
+    explicit operator bool() const JSONPP_NOEXCEPT {
+        return target != nullptr;
+    }
+
+    void bytes(std::size_t count) JSONPP_NOEXCEPT {
+        if(target != nullptr) {
+            target->bytes += count;
+        }
+    }
+};
+
+class stats_timer {
+private:
+    stats* target;
+    std::chrono::nanoseconds stats::* field;
+    std::chrono::steady_clock::time_point start;
+public:
+    explicit stats_timer(std::chrono::nanoseconds stats::* field) JSONPP_NOEXCEPT: target(thread_stats().active), field(field) {
+        if(target != nullptr) {
+            start = std::chrono::steady_clock::now();
+        }
+    }
+
+    stats_timer(const stats_timer&) = delete;
+    stats_timer& operator=(const stats_timer&) = delete;
+
+    ~stats_timer() {
+        if(target != nullptr) {
+            target->*field += std::chrono::steady_clock::now() - start;
+        }
+    }
+};
+
+// tracks the nesting of arrays and objects
+class stats_depth {
+private:
+    bool active;
+public:
+    stats_depth() JSONPP_NOEXCEPT: active(thread_stats().active != nullptr) {
+        if(active) {
+            auto& state = thread_stats();
+            if(++state.depth > state.active->max_depth) {
+                state.active->max_depth = state.depth;
+            }
+        }
+    }
+
+    stats_depth(const stats_depth&) = delete;
+    stats_depth& operator=(const stats_depth&) = delete;
+
+    ~stats_depth() {
+        if(active) {
+            --thread_stats().depth;
+        }
+    }
+};
+
+inline void record_value(stats_kind kind) JSONPP_NOEXCEPT {
+    auto target = thread_stats().active;
+    if(target == nullptr) {
+        return;
+    }
+
+    switch(kind) {
+    case stats_kind::null:
+        ++target->nulls;
+        break;
+    case stats_kind::boolean:
+        ++target->booleans;
+        break;
+    case stats_kind::number:
+        ++target->numbers;
+        break;
+    case stats_kind::string:
+        ++target->strings;
+        break;
+    case stats_kind::key:
+        ++target->keys;
+        break;
+    case stats_kind::array:
+        ++target->arrays;
+        break;
+    case stats_kind::object:
+        ++target->objects;
+        break;
+    }
+}
+
+inline void record_escaped_string() JSONPP_NOEXCEPT {
+    if(auto target = thread_stats().active) {
+        ++target->escaped_strings;
+    }
+}
+
+// counts the bytes written by the outermost dump
+template<typename OStream>
+struct counting_sink {
+    OStream& out;
+    std::size_t count;
+
+    void put(char ch) {
+        out.put(ch);
+        ++count;
+    }
+
+    void write(const char* str, std::size_t size) {
+        out.write(str, size);
+        count += size;
+    }
+};
+#else
+struct stats_session {
+    explicit stats_session(stats* stats_state::*) JSONPP_NOEXCEPT {}
+
+    explicit operator bool() const JSONPP_NOEXCEPT {
+        return false;
+    }
+
+    void bytes(std::size_t) JSONPP_NOEXCEPT {}
+};
+
+struct stats_timer {
+    explicit stats_timer(std::chrono::nanoseconds stats::*) JSONPP_NOEXCEPT {}
+};
+
+struct stats_depth {
+    stats_depth() JSONPP_NOEXCEPT {}
+};
+
+inline void record_value(stats_kind) JSONPP_NOEXCEPT {}
+inline void record_escaped_string() JSONPP_NOEXCEPT {}
+#endif
+} // detail
+
+// collects the stats of the parses and dumps made on this thread for as long as it lives
+// either pointer can be null to skip collecting that side, scopes nest and the innermost wins
+class stats_scope {
+#if defined(JSONPP_STATS)
+private:
+    stats* parse;
+    stats* dump;
+public:
+    explicit stats_scope(stats* parsing, stats* dumping = nullptr) JSONPP_NOEXCEPT {
+        auto& state = detail::thread_stats();
+        parse = state.parse;
+        dump = state.dump;
+        state.parse = parsing;
+        state.dump = dumping;
+    }
+
+    ~stats_scope() {
+        auto& state = detail::thread_stats();
+        state.parse = parse;
+        state.dump = dump;
+    }
+#else
+public:
+    explicit stats_scope(stats*, stats* = nullptr) JSONPP_NOEXCEPT {}
+#endif
+
+    stats_scope(const stats_scope&) = delete;
+    stats_scope& operator=(const stats_scope&) = delete;
+};
+
+// attributes a heap allocation of size bytes to the parse or dump running on this thread
+// the library cannot see the allocations made by the standard containers it uses, so
+// this is meant to be called from a replacement operator new or a custom allocator
+inline void record_allocation(std::size_t size) JSONPP_NOEXCEPT {
+#if defined(JSONPP_STATS)
+    if(auto target = detail::thread_stats().active) {
+        ++target->allocations;
+        target->allocated_bytes += size;
+    }
+#else
+    (void)size;
+#endif
+}
+} // json
+
+#endif // JSONPP_STATS_HPP
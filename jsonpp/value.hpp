@@ -24,17 +24,49 @@
 
 #include "type_traits.hpp"
 #include "dump.hpp"
+#include "detail/number.hpp"
+#include "detail/box.hpp"
+#include "detail/arena.hpp"
+#include "detail/hash.hpp"
 #include <string>
 #include <sstream>
 #include <map>
 #include <vector>
 #include <cassert>
 #include <cstdint>
+#include <cstring>
+#include <functional>
 #include <memory>
 #include <stdexcept>
 #include <iosfwd>
 
 namespace json {
+// tag type to construct a number from its textual representation
+struct raw_number_t {};
+constexpr raw_number_t raw_number{};
+
+// the heap memory used by a value and everything in it, in bytes
+// allocator bookkeeping is not included and the size of map nodes is estimated
+struct memory_stats {
+    std::size_t allocations = 0;  // heap blocks
+    std::size_t boxes = 0;        // the blocks holding strings, arrays and objects
+    std::size_t strings = 0;      // buffers of strings and keys too long to be stored inline
+    std::size_t string_slack = 0; // the unused capacity of those buffers
+    std::size_t arrays = 0;       // element buffers of arrays
+    std::size_t array_slack = 0;  // the unused capacity of those buffers
+    std::size_t objects = 0;      // the nodes of objects, each holding a key and a value
+    std::size_t numbers = 0;      // the share of lazily parsed numbers in the blocks of their parse
+
+    // the slack is part of strings and arrays
+    std::size_t total() const JSONPP_NOEXCEPT {
+        return boxes + strings + arrays + objects + numbers;
+    }
+
+    std::size_t slack() const JSONPP_NOEXCEPT {
+        return string_slack + array_slack;
+    }
+};
+
 class value {
 public:
     using object = std::map<std::string, value>;
@@ -43,25 +75,39 @@ private:
     union storage_t {
         double number;
         bool boolean;
-        std::string* str;
-        array* arr;
-        object* obj;
+        detail::box<std::string>* str;
+        const detail::arena_digits* digits;
+        detail::box<array>* arr;
+        detail::box<object>* obj;
     } storage;
     type storage_type;
+    bool lazy = false; // number is kept as its source digits
+
+    // the parser keeps digits in the arena of the parse, the reference is taken over
+    friend struct parser;
+
+    value(raw_number_t, const detail::arena_digits* digits) JSONPP_NOEXCEPT: storage_type(type::number), lazy(true) {
+        storage.digits = digits;
+    }
 
     void copy(const value& other) {
         switch(other.storage_type) {
         case type::array:
-            storage.arr = new array(*(other.storage.arr));
+            storage.arr = detail::copy_box(other.storage.arr);
             break;
         case type::string:
-            storage.str = new std::string(*(other.storage.str));
+            storage.str = detail::copy_box(other.storage.str);
             break;
         case type::object:
-            storage.obj = new object(*(other.storage.obj));
+            storage.obj = detail::copy_box(other.storage.obj);
             break;
         case type::number:
-            storage.number = other.storage.number;
+            if(other.lazy) {
+                storage.digits = detail::copy_digits(other.storage.digits);
+            }
+            else {
+                storage.number = other.storage.number;
+            }
             break;
         case type::boolean:
             storage.boolean = other.storage.boolean;
@@ -70,11 +116,142 @@ private:
             break;
         }
         storage_type = other.storage_type;
+        lazy = other.lazy;
     }
 
     template<typename T>
     struct is_generic : And<Not<is_string<T>>, Not<is_bool<T>>, Not<is_number<T>>,
                             Not<is_null<T>>, Not<std::is_same<T, object>>, Not<std::is_same<T, array>>> {};
+
+    const std::string* pointer(identity<std::string>) const JSONPP_NOEXCEPT {
+        return storage_type == type::string ? &storage.str->data : nullptr;
+    }
+
+    const array* pointer(identity<array>) const JSONPP_NOEXCEPT {
+        return storage_type == type::array ? &storage.arr->data : nullptr;
+    }
+
+    const object* pointer(identity<object>) const JSONPP_NOEXCEPT {
+        return storage_type == type::object ? &storage.obj->data : nullptr;
+    }
+
+    // mutable access has to detach shared payloads first
+    std::string* pointer(identity<std::string>) {
+        return storage_type == type::string ? &detail::unshare_box(storage.str)->data : nullptr;
+    }
+
+    array* pointer(identity<array>) {
+        return storage_type == type::array ? &detail::unshare_box(storage.arr)->data : nullptr;
+    }
+
+    object* pointer(identity<object>) {
+        return storage_type == type::object ? &detail::unshare_box(storage.obj)->data : nullptr;
+    }
+
+    static const value& null_value() JSONPP_NOEXCEPT {
+        static const value result;
+        return result;
+    }
+
+    template<typename T, typename Function>
+    static std::uint64_t memoized_hash(const detail::box<T>* b, bool memoize, Function compute) {
+#if defined(JSONPP_MEMOIZE_HASH)
+        if(memoize) {
+            auto result = b->hash.load(std::memory_order_relaxed);
+            if(result == 0) {
+                result = compute(b->data);
+                b->hash.store(result, std::memory_order_relaxed);
+            }
+            return result;
+        }
+#else
+        (void)memoize;
+#endif
+        return compute(b->data);
+    }
+
+    static void measure_string(const std::string& str, memory_stats& stats) JSONPP_NOEXCEPT {
+        // strings short enough for the inline buffer have the capacity of an empty one
+        static const std::size_t inline_capacity = std::string().capacity();
+        if(str.capacity() > inline_capacity) {
+            ++stats.allocations;
+            stats.strings += str.capacity() + 1;
+            stats.string_slack += str.capacity() - str.size();
+        }
+    }
+
+    // shared boxes are only counted the first time they are reached
+    template<typename T>
+    static bool measure_box(const detail::box<T>* b, memory_stats& stats, detail::seen_boxes& seen) {
+        if(!seen.insert(b)) {
+            return false;
+        }
+        ++stats.allocations;
+        stats.boxes += sizeof(*b);
+        return true;
+    }
+
+    void measure(memory_stats& stats, detail::seen_boxes& seen) const {
+        // a red-black tree node also holds three links and a colour in the common implementations
+        static const std::size_t node_size = sizeof(object::value_type) + 4 * sizeof(void*);
+        switch(storage_type) {
+        case type::string:
+            if(measure_box(storage.str, stats, seen)) {
+                measure_string(storage.str->data, stats);
+            }
+            break;
+        case type::number:
+            if(lazy) {
+                stats.numbers += detail::number_arena::entry_size(storage.digits->size);
+            }
+            break;
+        case type::array:
+            if(measure_box(storage.arr, stats, seen)) {
+                auto&& arr = storage.arr->data;
+                if(arr.capacity() != 0) {
+                    ++stats.allocations;
+                    stats.arrays += arr.capacity() * sizeof(value);
+                    stats.array_slack += (arr.capacity() - arr.size()) * sizeof(value);
+                }
+
+                for(auto&& elem : arr) {
+                    elem.measure(stats, seen);
+                }
+            }
+            break;
+        case type::object:
+            if(measure_box(storage.obj, stats, seen)) {
+                auto&& obj = storage.obj->data;
+                stats.allocations += obj.size();
+                stats.objects += obj.size() * node_size;
+                for(auto&& member : obj) {
+                    measure_string(member.first, stats);
+                    member.second.measure(stats, seen);
+                }
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    // the memoized hash of a string, array or object or zero if there is none
+    std::uint64_t known_hash() const JSONPP_NOEXCEPT {
+#if defined(JSONPP_MEMOIZE_HASH)
+        switch(storage_type) {
+        case type::string:
+            return storage.str->hash.load(std::memory_order_relaxed);
+        case type::array:
+            return storage.arr->hash.load(std::memory_order_relaxed);
+        case type::object:
+            return storage.obj->hash.load(std::memory_order_relaxed);
+        default:
+            return 0;
+        }
+#else
+        return 0;
+#endif
+    }
 public:
     value() JSONPP_NOEXCEPT: storage_type(type::null) {}
     value(null) JSONPP_NOEXCEPT: storage_type(type::null) {}
@@ -95,22 +272,34 @@ public:
 
     template<typename T, EnableIf<is_string<T>, Not<is_bool<T>>> = 0>
     value(const T& str): storage_type(type::string) {
-        storage.str = new std::string(str);
+        storage.str = detail::make_box<std::string>(str);
+    }
+
+    value(raw_number_t, const std::string& digits): storage_type(type::number), lazy(true) {
+        storage.digits = detail::make_digits(digits.data(), digits.size());
     }
 
     template<typename T, EnableIf<has_to_json<T>, Not<is_string<T>>, Not<is_bool<T>>> = 0>
     value(const T& t): value(to_json(t)) {}
 
     value(const array& arr): storage_type(type::array) {
-        storage.arr = new array(arr);
+        storage.arr = detail::make_box<array>(arr);
     }
 
     value(const object& obj): storage_type(type::object) {
-        storage.obj = new object(obj);
+        storage.obj = detail::make_box<object>(obj);
+    }
+
+    value(array&& arr): storage_type(type::array) {
+        storage.arr = detail::make_box<array>(std::move(arr));
+    }
+
+    value(object&& obj): storage_type(type::object) {
+        storage.obj = detail::make_box<object>(std::move(obj));
     }
 
     value(std::initializer_list<array::value_type> l): storage_type(type::array) {
-        storage.arr = new array(l.begin(), l.end());
+        storage.arr = detail::make_box<array>(l.begin(), l.end());
     }
 
     value(const value& other) {
@@ -135,14 +324,22 @@ public:
             storage.boolean = other.storage.boolean;
             break;
         case type::number:
-            storage.number = other.storage.number;
+            if(other.lazy) {
+                storage.digits = other.storage.digits;
+                other.storage.digits = nullptr;
+            }
+            else {
+                storage.number = other.storage.number;
+            }
             break;
         default:
             break;
         }
 
         storage_type = other.storage_type;
+        lazy = other.lazy;
         other.storage_type = type::null;
+        other.lazy = false;
     }
 
     template<typename T, EnableIf<has_to_json<T>, Not<is_string<T>>, Not<is_bool<T>>> = 0>
@@ -176,14 +373,22 @@ public:
             storage.boolean = other.storage.boolean;
             break;
         case type::number:
-            storage.number = other.storage.number;
+            if(other.lazy) {
+                storage.digits = other.storage.digits;
+                other.storage.digits = nullptr;
+            }
+            else {
+                storage.number = other.storage.number;
+            }
             break;
         default:
             break;
         }
 
         storage_type = other.storage_type;
+        lazy = other.lazy;
         other.storage_type = type::null;
+        other.lazy = false;
         return *this;
     }
 
@@ -209,18 +414,24 @@ public:
     void clear() JSONPP_NOEXCEPT {
         switch(storage_type) {
         case type::array:
-            delete storage.arr;
+            detail::release_box(storage.arr);
             break;
         case type::string:
-            delete storage.str;
+            detail::release_box(storage.str);
             break;
         case type::object:
-            delete storage.obj;
+            detail::release_box(storage.obj);
+            break;
+        case type::number:
+            if(lazy) {
+                detail::release_digits(storage.digits);
+            }
             break;
         default:
             break;
         }
         storage_type = type::null;
+        lazy = false;
     }
 
     template<typename T, EnableIf<is_string<T>> = 0>
@@ -261,13 +472,13 @@ public:
     template<typename T, EnableIf<std::is_same<T, const char*>> = 0>
     T as() const {
         assert(is<T>());
-        return storage.str->c_str();
+        return storage.str->data.c_str();
     }
 
     template<typename T, EnableIf<std::is_same<T, std::string>> = 0>
     T as() const {
         assert(is<T>());
-        return *(storage.str);
+        return storage.str->data;
     }
 
     template<typename T, EnableIf<is_null<T>> = 0>
@@ -285,19 +496,22 @@ public:
     template<typename T, EnableIf<is_number<T>> = 0>
     T as() const {
         assert(is<T>());
+        if(lazy) {
+            return detail::from_digits<T>(storage.digits->data(), storage.digits->size);
+        }
         return storage.number;
     }
 
     template<typename T, EnableIf<std::is_same<T, object>> = 0>
     T as() const {
         assert(is<T>());
-        return *(storage.obj);
+        return storage.obj->data;
     }
 
     template<typename T, EnableIf<std::is_same<T, array>> = 0>
     T as() const {
         assert(is<T>());
-        return *(storage.arr);
+        return storage.arr->data;
     }
 
     template<typename T, EnableIf<is_generic<T>> = 0>
@@ -310,54 +524,236 @@ public:
         return is<T>() ? as<T>() : std::forward<T>(def);
     }
 
-    template<typename T, EnableIf<is_string<T>> = 0>
-    value operator[](const T& str) const {
+    std::string number_text() const {
+        assert(is<double>());
+        if(lazy) {
+            return std::string(storage.digits->data(), storage.digits->size);
+        }
+        return dump_string(storage.number, format_options(0, format_options::minify));
+    }
+
+    template<typename T>
+    T* get_if() {
+        return pointer(identity<T>{});
+    }
+
+    template<typename T>
+    const T* get_if() const JSONPP_NOEXCEPT {
+        return pointer(identity<T>{});
+    }
+
+    template<typename T>
+    T& get() {
+        assert(is<T>());
+        return *pointer(identity<T>{});
+    }
+
+    template<typename T>
+    const T& get() const JSONPP_NOEXCEPT {
+        assert(is<T>());
+        return *pointer(identity<T>{});
+    }
+
+    value* find(const std::string& key) {
+#if defined(JSONPP_COPY_ON_WRITE)
+        // avoid detaching the object when there is nothing to hand out
+        if(static_cast<const value&>(*this).find(key) == nullptr) {
+            return nullptr;
+        }
+#endif
         if(!is<object>()) {
-            return {};
+            return nullptr;
         }
 
-        auto it = storage.obj->find(str);
-        if(it != storage.obj->end()) {
-            return it->second;
+        auto&& obj = *pointer(identity<object>{});
+        auto it = obj.find(key);
+        return it != obj.end() ? &it->second : nullptr;
+    }
+
+    const value* find(const std::string& key) const {
+        if(!is<object>()) {
+            return nullptr;
         }
-        return {};
+
+        auto&& obj = storage.obj->data;
+        auto it = obj.find(key);
+        return it != obj.end() ? &it->second : nullptr;
+    }
+
+    template<typename T, EnableIf<is_string<T>> = 0>
+    const value& operator[](const T& str) const {
+        auto ptr = find(str);
+        return ptr != nullptr ? *ptr : null_value();
     }
 
     template<typename T, EnableIf<is_number<T>> = 0>
-    value operator[](const T& index) const {
+    const value& operator[](const T& index) const {
         if(!is<array>()) {
-            return {};
+            return null_value();
         }
 
-        auto&& arr = *storage.arr;
+        auto&& arr = storage.arr->data;
 
         if(static_cast<size_t>(index) < arr.size()) {
             return arr[index];
         }
-        return {};
+        return null_value();
     }
 
-    template<typename OStream>
-    friend OStream& dump(OStream& out, const value& val, format_options opt = {}) {
-        switch(val.storage_type) {
-        case type::array:
-            return dump(out, *val.storage.arr, opt);
+    // the heap memory owned by the value, which does not include the value itself
+    // with JSONPP_COPY_ON_WRITE payloads shared within the value are counted once
+    memory_stats memory_usage() const {
+        memory_stats result;
+        detail::seen_boxes seen;
+        measure(result, seen);
+        return result;
+    }
+
+    // a structural hash that is equal for values that compare equal
+    // members contribute to the hash of an object regardless of their order
+    // with memoize and JSONPP_MEMOIZE_HASH the hash of each string, array and object is stored
+    // in it and reused until it is accessed through a non-const member function
+    std::uint64_t hash(bool memoize = false) const {
+        switch(storage_type) {
         case type::string:
-            return dump(out, *val.storage.str, opt);
+            return memoized_hash(storage.str, memoize, [](const std::string& str) {
+                return detail::mix64(detail::hash_bytes(str.data(), str.size()) + 0x5354);
+            });
+        case type::array:
+            return memoized_hash(storage.arr, memoize, [memoize](const array& arr) {
+                std::uint64_t result = 0x4152 ^ arr.size();
+                for(auto&& elem : arr) {
+                    result = detail::mix64(result ^ elem.hash(memoize));
+                }
+                return result;
+            });
         case type::object:
-            return dump(out, *val.storage.obj, opt);
+            return memoized_hash(storage.obj, memoize, [memoize](const object& obj) {
+                std::uint64_t result = 0;
+                for(auto&& member : obj) {
+                    result += detail::mix64(detail::hash_bytes(member.first.data(), member.first.size()) * 31 + member.second.hash(memoize));
+                }
+                return detail::mix64(result ^ 0x4f42 ^ obj.size());
+            });
+        case type::number: {
+            // -0.0 == 0.0 so they need to hash the same
+            double d = as<double>();
+            d = d == 0 ? 0 : d;
+            std::uint64_t bits;
+            std::memcpy(&bits, &d, sizeof(bits));
+            return detail::mix64(bits ^ 0x4e55);
+        }
         case type::boolean:
-            return dump(out, val.storage.boolean, opt);
+            return detail::mix64(storage.boolean ? 0x5452 : 0x4641);
+        default:
+            return detail::mix64(0x4e4c);
+        }
+    }
+
+    // numbers compare by their double value and objects by their members
+    // containers of different sizes or with different memoized hashes are unequal right away
+    friend bool operator==(const value& lhs, const value& rhs) {
+        if(lhs.storage_type != rhs.storage_type) {
+            return false;
+        }
+
+        auto lhs_hash = lhs.known_hash();
+        auto rhs_hash = rhs.known_hash();
+        if(lhs_hash != 0 && rhs_hash != 0 && lhs_hash != rhs_hash) {
+            return false;
+        }
+
+        switch(lhs.storage_type) {
+        case type::string:
+            return lhs.storage.str == rhs.storage.str || lhs.storage.str->data == rhs.storage.str->data;
+        case type::array:
+            return lhs.storage.arr == rhs.storage.arr || lhs.storage.arr->data == rhs.storage.arr->data;
+        case type::object:
+            return lhs.storage.obj == rhs.storage.obj || lhs.storage.obj->data == rhs.storage.obj->data;
         case type::number:
-            return dump(out, val.storage.number, opt);
-        case type::null:
-            return dump(out, nullptr, opt);
+            return lhs.as<double>() == rhs.as<double>();
+        case type::boolean:
+            return lhs.storage.boolean == rhs.storage.boolean;
         default:
-            return out;
+            return true;
         }
     }
+
+    friend bool operator!=(const value& lhs, const value& rhs) {
+        return !(lhs == rhs);
+    }
+
+private:
+#if defined(JSONPP_STATS)
+    // counts the bytes written by the outermost dump
+    template<typename OStream>
+    static void dump_counted(OStream& out, const value& val, const format_options& opt, detail::stats_session& session) {
+        detail::counting_sink<OStream> counter{ out, 0 };
+        dump(counter, val, opt);
+        session.bytes(counter.count);
+    }
+
+    // a session never starts inside another one, this only keeps the sinks from nesting at compile time
+    template<typename OStream>
+    static void dump_counted(detail::counting_sink<OStream>& out, const value& val, const format_options& opt, detail::stats_session&) {
+        dump(out, val, opt);
+    }
+#endif
+
+    // defined out of line so that JSONPP_SEPARATE_COMPILATION can keep it out of other translation units
+    template<typename OStream>
+    static OStream& dump_value(OStream& out, const value& val, const format_options& opt);
+public:
+    template<typename OStream>
+    friend OStream& dump(OStream& out, const value& val, format_options opt = {}) {
+        return dump_value(out, val, opt);
+    }
 };
 
+template<typename OStream>
+OStream& value::dump_value(OStream& out, const value& val, const format_options& opt) {
+#if defined(JSONPP_STATS)
+    // the outermost dump collects for the nested ones
+    detail::stats_session session(&detail::stats_state::dump);
+    if(session) {
+        dump_counted(out, val, opt, session);
+        return out;
+    }
+#endif
+    switch(val.storage_type) {
+    case type::array: {
+        detail::record_value(detail::stats_kind::array);
+        detail::stats_depth depth;
+        return dump(out, val.storage.arr->data, opt);
+    }
+    case type::string:
+        detail::record_value(detail::stats_kind::string);
+        return dump(out, val.storage.str->data, opt);
+    case type::object: {
+        detail::record_value(detail::stats_kind::object);
+        detail::stats_depth depth;
+        return dump(out, val.storage.obj->data, opt);
+    }
+    case type::boolean:
+        detail::record_value(detail::stats_kind::boolean);
+        return dump(out, val.storage.boolean, opt);
+    case type::number: {
+        detail::record_value(detail::stats_kind::number);
+        detail::stats_timer timer(&stats::number_time);
+        if(val.lazy) {
+            detail::write(out, val.storage.digits->data(), val.storage.digits->size);
+            return out;
+        }
+        return dump(out, val.storage.number, opt);
+    }
+    case type::null:
+        detail::record_value(detail::stats_kind::null);
+        return dump(out, nullptr, opt);
+    default:
+        return out;
+    }
+}
+
 using array  = value::array;
 using object = value::object;
 
@@ -370,6 +766,22 @@ template<typename T>
 inline auto value_cast(const value& v, T&& def) -> decltype(v.as<Unqualified<T>>(std::forward<T>(def))) {
     return v.as<Unqualified<T>>(std::forward<T>(def));
 }
+
+#if defined(JSONPP_SEPARATE_COMPILATION)
+// instantiated once in the library, other streams are still instantiated where they are used
+JSONPP_EXTERN template std::ostream& value::dump_value<std::ostream>(std::ostream&, const value&, const format_options&);
+JSONPP_EXTERN template std::ostringstream& value::dump_value<std::ostringstream>(std::ostringstream&, const value&, const format_options&);
+JSONPP_EXTERN template string_sink& value::dump_value<string_sink>(string_sink&, const value&, const format_options&);
+#endif
 } // json
 
+namespace std {
+template<>
+struct hash<json::value> {
+    size_t operator()(const json::value& v) const {
+        return static_cast<size_t>(v.hash());
+    }
+};
+} // std
+
 #endif // JSONPP_VALUE_HPP
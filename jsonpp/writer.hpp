@@ -0,0 +1,156 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef JSONPP_WRITER_HPP
+#define JSONPP_WRITER_HPP
+
+#include "dump.hpp"
+#include <vector>
+#include <cassert>
+
+namespace json {
+// writes JSON incrementally to a sink without building a value first
+// the output is the same as dumping the equivalent value with the same options
+template<typename OStream>
+class writer {
+private:
+    struct frame {
+        bool object;
+        bool empty;
+    };
+
+    OStream& out;
+    format_options opt;
+    std::vector<frame> frames;
+    bool prettify;
+    bool has_key = false;
+    bool has_root = false;
+
+    void separate(frame& top) {
+        if(not top.empty) {
+            out.put(',');
+        }
+        top.empty = false;
+
+        if(prettify) {
+            detail::indent(out, opt);
+        }
+    }
+
+    void prepare_value() {
+        if(frames.empty()) {
+            assert(!has_root && "only a single root value can be written");
+            has_root = true;
+            return;
+        }
+
+        auto&& top = frames.back();
+        if(top.object) {
+            assert(has_key && "object members must begin with a key");
+            has_key = false;
+            return;
+        }
+        separate(top);
+    }
+
+    void begin(bool object) {
+        prepare_value();
+        out.put(object ? '{' : '[');
+        frames.push_back({ object, true });
+        opt.depth += prettify;
+    }
+
+    void end(bool object) {
+        assert(!frames.empty() && frames.back().object == object && "mismatched end of array or object");
+        assert(!has_key && "object key has no value");
+        bool empty = frames.back().empty;
+        frames.pop_back();
+
+        if(prettify) {
+            --opt.depth;
+            if(not empty) {
+                detail::indent(out, opt);
+            }
+        }
+        out.put(object ? '}' : ']');
+    }
+public:
+    writer(OStream& out, format_options opt = {}): out(out), opt(opt), prettify((opt.flags & opt.minify) != opt.minify) {}
+
+    writer& begin_object() {
+        begin(true);
+        return *this;
+    }
+
+    writer& end_object() {
+        end(true);
+        return *this;
+    }
+
+    writer& begin_array() {
+        begin(false);
+        return *this;
+    }
+
+    writer& end_array() {
+        end(false);
+        return *this;
+    }
+
+    writer& key(const std::string& str) {
+        assert(!frames.empty() && frames.back().object && "keys can only be written inside objects");
+        assert(!has_key && "object key has no value");
+        separate(frames.back());
+        dump(out, str, opt);
+        out.put(':');
+
+        if(prettify) {
+            out.put(' ');
+        }
+        has_key = true;
+        return *this;
+    }
+
+    // writes anything that dump accepts, including json::value
+    template<typename T>
+    writer& value(const T& t) {
+        prepare_value();
+        dump(out, t, opt);
+        return *this;
+    }
+
+    // whether every array and object that was begun has been ended
+    bool complete() const JSONPP_NOEXCEPT {
+        return has_root && frames.empty();
+    }
+
+    std::size_t depth() const JSONPP_NOEXCEPT {
+        return frames.size();
+    }
+};
+
+template<typename OStream>
+inline writer<OStream> make_writer(OStream& out, format_options opt = {}) {
+    return { out, opt };
+}
+} // json
+
+#endif // JSONPP_WRITER_HPP
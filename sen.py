@@ -174,11 +174,15 @@ class Compiler(object):
                               deps = 'gcc', depfile = '$out.d',
                               description = 'Compiling $in to $out')
         ninja.rule('link', command = '$cxx $cxxflags $in -o $out $linkflags $libpath $libraries', description = 'Creating $out')
+        ninja.rule('archive', command = 'rm -f $out && ar rcs $out $in', description = 'Creating $out')
 
     def object_file(self, filename):
         (root, _) = os.path.splitext(filename)
         return root + '.o'
 
+    def archive_file(self, name):
+        return 'lib' + name + '.a'
+
     def include(self, path):
         return "-I\"{}\"".format(path)
 
@@ -221,6 +225,17 @@ class Executable(Options):
         self.target   = kwargs.get('target', None)
         self.files    = None
         self.run      = kwargs.get('run', None) # the name of the target that runs the executable
+        self.link_with = None # the libraries made by the project to link against
+
+"""Represents a static library to be made."""
+class Library(Options):
+    def __init__(self, name, **kwargs):
+        Options.__init__(self, kwargs)
+        self.name = name # the library name, without the lib prefix or extension
+        self.builddir = kwargs.get('builddir', None) # the library specific output directory
+        self.objdir   = kwargs.get('objdir', None)   # the library specific object directory
+        self.target   = kwargs.get('target', None)
+        self.files    = None
 
 # monadic functions
 def to_flags(flags):
@@ -250,6 +265,7 @@ class Project(Options):
         self.name = name
         self.compiler = compiler
         self.executables = []
+        self.libraries_made = []
         self.sstream = StringIO.StringIO()
         self.ninja = NinjaWriter(self.sstream)
         self.builddir = kwargs.get('builddir', '.')
@@ -278,6 +294,24 @@ class Project(Options):
             raise ValueError("argument passed must be an 'Executable'")
         self.executables.append(exe)
 
+    def add_library(self, lib):
+        if not isinstance(lib, Library):
+            raise ValueError("argument passed must be a 'Library'")
+        self.libraries_made.append(lib)
+
+    def __compile(self, target, variables):
+        object_files = []
+        objdir = target.objdir if target.objdir else self.objdir
+        for filename in target.files:
+            obj = os.path.join(objdir, self.compiler.object_file(filename))
+            self.ninja.build(obj, 'compile', inputs=filename, variables=variables)
+            object_files.append(obj)
+        return object_files
+
+    def __archive_path(self, lib):
+        builddir = lib.builddir if lib.builddir else self.builddir
+        return os.path.join(builddir, self.compiler.archive_file(lib.name))
+
     def dump(self, stream, generator=True):
         # create the global variables needed
         today = datetime.datetime.today()
@@ -297,6 +331,17 @@ class Project(Options):
             self.ninja.rule('bootstrap', command=' '.join(['python'] + sys.argv), generator=True)
             self.ninja.build(stream.name, 'bootstrap', implicit=sys.argv[0])
 
+        # register the libraries requested
+        for lib in self.libraries_made:
+            if lib.files == None:
+                continue
+
+            object_files = self.__compile(lib, self.__create_variable_map(lib))
+            archive = self.__archive_path(lib)
+            self.ninja.build(archive, 'archive', inputs=object_files)
+            if lib.target != None:
+                self.ninja.build(lib.target, 'phony', inputs=archive)
+
         # register the executables requested
         for exe in self.executables:
             if exe.files == None:
@@ -305,12 +350,11 @@ class Project(Options):
             exe_variables = self.__create_variable_map(exe)
 
             # compile the files in the project
-            object_files = []
-            objdir = exe.objdir if exe.objdir else self.objdir
-            for filename in exe.files:
-                obj = os.path.join(objdir, self.compiler.object_file(filename))
-                self.ninja.build(obj, 'compile', inputs=filename, variables=exe_variables)
-                object_files.append(obj)
+            object_files = self.__compile(exe, exe_variables)
+
+            # archives go after the objects that use them
+            if exe.link_with != None:
+                object_files.extend(self.__archive_path(lib) for lib in exe.link_with)
 
             # final link step
             builddir = exe.builddir if exe.builddir else self.builddir
@@ -46,4 +46,29 @@ TEST_CASE("accessors", "[subscripts-accessors]") {
         REQUIRE(v[0]["test"].is<int>());
         REQUIRE(v[0]["test"].as<int>() == 1);
     };
+
+    SECTION("references into the tree") {
+        const json::value& elem = v[0];
+        REQUIRE(&elem == &v.get<json::array>()[0]);
+        REQUIRE(&v[0]["test"] == v[0].find("test"));
+        REQUIRE(&v[10] == &v[11]); // shared null value
+
+        REQUIRE(o.find("key") != nullptr);
+        REQUIRE(o.find("key")->get<std::string>() == "value");
+        REQUIRE(o.find("unexist") == nullptr);
+        REQUIRE(v.find("key") == nullptr);
+
+        REQUIRE(v.get_if<json::array>() != nullptr);
+        REQUIRE(v.get_if<json::object>() == nullptr);
+        REQUIRE(v[2].get_if<std::string>() != nullptr);
+        REQUIRE(*v[2].get_if<std::string>() == "my_string");
+
+        o.get<json::object>()["int"] = 2;
+        REQUIRE(o["int"].as<int>() == 2);
+
+        auto ptr = o.find("key");
+        REQUIRE(ptr != nullptr);
+        ptr->get<std::string>() += "s";
+        REQUIRE(o["key"].as<std::string>() == "values");
+    };
 }
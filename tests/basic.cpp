@@ -95,6 +95,51 @@ TEST_CASE("numbers", "[basic-numbers]") {
         REQUIRE(json::dump_string(v, minify) == "1.23456");
     }
 
+    SECTION("lazy") {
+        json::parse_options lazy = json::parse_options::lazy_numbers;
+        REQUIRE_NOTHROW(json::parse("\t\n\n10", v, lazy));
+        REQUIRE(v.is<int>());
+        REQUIRE(v.is<double>());
+        REQUIRE(v.as<int>() == 10);
+        REQUIRE(v.number_text() == "10");
+
+        REQUIRE_NOTHROW(json::parse("3.14159265358979323846264338327950288", v, lazy));
+        REQUIRE(v.as<double>() == 3.14159265358979323846264338327950288);
+        REQUIRE(json::dump_string(v, minify) == "3.14159265358979323846264338327950288");
+
+        REQUIRE_NOTHROW(json::parse("[9007199254740993, -9007199254740993, 1e2]", v, lazy));
+        REQUIRE(v[0].as<long long>() == 9007199254740993LL);
+        REQUIRE(v[1].as<long long>() == -9007199254740993LL);
+        REQUIRE(v[2].as<int>() == 100);
+        REQUIRE(json::dump_string(v, minify) == "[9007199254740993,-9007199254740993,1e2]");
+
+        json::value copy = v;
+        REQUIRE(json::dump_string(copy, minify) == json::dump_string(v, minify));
+
+        // the digits outlive the parse and the value they were parsed into
+        json::value first = v[0];
+        json::value moved = std::move(copy);
+        v = nullptr;
+        REQUIRE(first.number_text() == "9007199254740993");
+        REQUIRE(moved[2].number_text() == "1e2");
+        REQUIRE(json::dump_string(moved, minify) == "[9007199254740993,-9007199254740993,1e2]");
+
+        // digits longer than a block of the arena and enough numbers to fill several blocks
+        std::string text = "[" + std::string(3000, '7');
+        for(int i = 0; i < 200; ++i) {
+            text += ", " + std::to_string(i);
+        }
+        REQUIRE_NOTHROW(json::parse(text + "]", v, lazy));
+        REQUIRE(v[0].number_text() == std::string(3000, '7'));
+        REQUIRE(v[200].as<int>() == 199);
+
+        REQUIRE_THROWS(json::parse("+1", v, lazy));
+        REQUIRE_THROWS(json::parse("1.", v, lazy));
+        REQUIRE_THROWS(json::parse("1e", v, lazy));
+        REQUIRE_THROWS(json::parse("-", v, lazy));
+        REQUIRE_THROWS(json::parse("10x12", v, lazy));
+    }
+
     SECTION("invalid") {
         REQUIRE_THROWS(json::parse("10x12", v));
         REQUIRE_THROWS(json::parse("1'0", v));
@@ -151,6 +196,38 @@ TEST_CASE("strings", "[basic-strings]") {
         auto&& str2 = v.as<std::string>();
         REQUIRE(str2.size() == 10);
         REQUIRE(str2 == u8"\t\n\b\"\u2000\u1234");
+
+    }
+
+    SECTION("surrogate pairs") {
+        // a high surrogate used to be rejected whatever followed it
+        REQUIRE_NOTHROW(json::parse(R"("a\ud83d\ude00b")", v));
+        REQUIRE(v.as<std::string>() == u8"a\U0001F600b");
+        REQUIRE_NOTHROW(json::parse(R"("\uD800\uDC00\uDBFF\uDFFF")", v));
+        REQUIRE(v.as<std::string>() == u8"\U00010000\U0010FFFF");
+        REQUIRE_NOTHROW(json::parse(R"(["\ud83d\ude00\n", "\ud83d\ude00"])", v));
+        REQUIRE(v[0].as<std::string>() == u8"\U0001F600\n");
+        REQUIRE(v[1].as<std::string>() == u8"\U0001F600");
+
+        REQUIRE_THROWS_AS(json::parse(R"("\ud83d")", v), json::parser_error);
+        REQUIRE_THROWS_AS(json::parse(R"("\ud83dx\ude00")", v), json::parser_error);
+        REQUIRE_THROWS_AS(json::parse(R"("\ud83d\n")", v), json::parser_error);
+        REQUIRE_THROWS_AS(json::parse(R"("\ud83d\u0041")", v), json::parser_error);
+        REQUIRE_THROWS_AS(json::parse(R"("\ud83d\)", v), json::parser_error);
+        REQUIRE_THROWS_AS(json::parse(R"("\ude00")", v), json::parser_error);
+
+        // the columns after a pair are counted like after any other two escapes
+        auto error = [&v](const char* str) -> std::string {
+            try {
+                json::parse(str, v);
+            }
+            catch(const json::parser_error& e) {
+                return e.what();
+            }
+            return {};
+        };
+        REQUIRE(!error(R"(["\ud83d\ude00" x])").empty());
+        REQUIRE(error(R"(["\ud83d\ude00" x])") == error(R"(["\u00e9\u00e9" x])"));
     }
 
     SECTION("regular string") {
@@ -321,6 +398,8 @@ TEST_CASE("arrays", "[basic-arrays]") {
         REQUIRE_THROWS(json::parse("[1, 2,]", v));
         REQUIRE_THROWS(json::parse("[1 2]", v));
         REQUIRE_THROWS(json::parse("[]]", v));
+        REQUIRE_THROWS(json::parse("[1,", v));
+        REQUIRE_THROWS(json::parse("[1, ", v));
     }
 }
 
@@ -511,5 +590,9 @@ TEST_CASE("objects", "[basic-objects]") {
         REQUIRE_THROWS(json::parse("{ \"hello\": null goodbye: true }", v));
         REQUIRE_THROWS(json::parse("{}}", v));
         REQUIRE_THROWS(json::parse("{{ }", v));
+        REQUIRE_THROWS_AS(json::parse("{\"a\": 1,}", v), json::parser_error);
+        REQUIRE_THROWS_AS(json::parse("{\"a\": 1, }", v), json::parser_error);
+        REQUIRE_THROWS_AS(json::parse("{\"a\": 1,", v), json::parser_error);
+        REQUIRE_THROWS_AS(json::parse("{\"a\": 1", v), json::parser_error);
     }
 }
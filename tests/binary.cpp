@@ -0,0 +1,238 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <catch.hpp>
+#include <jsonpp/msgpack.hpp>
+#include <jsonpp/cbor.hpp>
+#include <jsonpp/parser.hpp>
+#include <fstream>
+#include <sstream>
+#include <cmath>
+
+namespace {
+std::string bytes(std::initializer_list<unsigned> list) {
+    std::string result;
+    for(auto&& byte : list) {
+        result.push_back(static_cast<char>(byte));
+    }
+    return result;
+}
+
+json::value round_trip_msgpack(const json::value& v) {
+    json::value result;
+    json::msgpack::parse(json::msgpack::dump_string(v), result);
+    return result;
+}
+
+json::value round_trip_cbor(const json::value& v) {
+    json::value result;
+    json::cbor::parse(json::cbor::dump_string(v), result);
+    return result;
+}
+
+std::string text(const json::value& v) {
+    return json::dump_string(v, json::format_options(0, json::format_options::minify));
+}
+} // anonymous namespace
+
+TEST_CASE("MessagePack", "[msgpack]") {
+    SECTION("encoding") {
+        REQUIRE(json::msgpack::dump_string(nullptr) == bytes({ 0xc0 }));
+        REQUIRE(json::msgpack::dump_string(true) == bytes({ 0xc3 }));
+        REQUIRE(json::msgpack::dump_string(127) == bytes({ 0x7f }));
+        REQUIRE(json::msgpack::dump_string(128) == bytes({ 0xcc, 0x80 }));
+        REQUIRE(json::msgpack::dump_string(65536) == bytes({ 0xce, 0x00, 0x01, 0x00, 0x00 }));
+        REQUIRE(json::msgpack::dump_string(-32) == bytes({ 0xe0 }));
+        REQUIRE(json::msgpack::dump_string(-33) == bytes({ 0xd0, 0xdf }));
+        REQUIRE(json::msgpack::dump_string(-129) == bytes({ 0xd1, 0xff, 0x7f }));
+        REQUIRE(json::msgpack::dump_string(1.5) == bytes({ 0xca, 0x3f, 0xc0, 0x00, 0x00 }));
+        REQUIRE(json::msgpack::dump_string(0.1) == bytes({ 0xcb, 0x3f, 0xb9, 0x99, 0x99, 0x99, 0x99, 0x99, 0x9a }));
+        REQUIRE(json::msgpack::dump_string("abc") == bytes({ 0xa3, 'a', 'b', 'c' }));
+        REQUIRE(json::msgpack::dump_string(std::string(40, 'x')).substr(0, 2) == bytes({ 0xd9, 40 }));
+        REQUIRE(json::msgpack::dump_string(json::array{ 1, "a" }) == bytes({ 0x92, 0x01, 0xa1, 'a' }));
+        REQUIRE(json::msgpack::dump_string(json::object{ { "a", nullptr } }) == bytes({ 0x81, 0xa1, 'a', 0xc0 }));
+        REQUIRE(json::msgpack::dump_string(json::array(20)).substr(0, 3) == bytes({ 0xdc, 0x00, 20 }));
+    }
+
+    SECTION("round trip") {
+        json::value v = json::object{ { "n", -123456789 }, { "d", 3.14159 }, { "s", "h\xc3\xa9llo" },
+                                      { "a", json::array{ true, false, nullptr, json::object{} } } };
+        REQUIRE(text(round_trip_msgpack(v)) == text(v));
+    }
+
+    SECTION("large integers") {
+        json::value v;
+        json::parse("[18446744073709551615, -9223372036854775808, 9007199254740993]", v, json::parse_options::lazy_numbers);
+        auto result = round_trip_msgpack(v);
+        REQUIRE(text(result) == "[18446744073709551615,-9223372036854775808,9007199254740993]");
+        REQUIRE(result[0].as<unsigned long long>() == 18446744073709551615ull);
+    }
+
+    SECTION("negative zero") {
+        REQUIRE(json::msgpack::dump_string(-0.0) == bytes({ 0xca, 0x80, 0x00, 0x00, 0x00 }));
+        REQUIRE(json::msgpack::dump_string(0.0) == bytes({ 0x00 }));
+        REQUIRE(std::signbit(round_trip_msgpack(-0.0).as<double>()));
+        REQUIRE(!std::signbit(round_trip_msgpack(0.0).as<double>()));
+    }
+
+    SECTION("invalid") {
+        json::value v;
+        REQUIRE_THROWS_AS(json::msgpack::parse(bytes({ 0xa3, 'a' }), v), json::parser_error);
+        REQUIRE_THROWS_AS(json::msgpack::parse(bytes({ 0xdd, 0xff, 0xff, 0xff, 0xff }), v), json::parser_error);
+        REQUIRE_THROWS_AS(json::msgpack::parse(bytes({ 0x81, 0x01, 0x01 }), v), json::parser_error);
+        REQUIRE_THROWS_AS(json::msgpack::parse(bytes({ 0xc1 }), v), json::parser_error);
+        REQUIRE_THROWS_AS(json::msgpack::parse(bytes({ 0xc0, 0xc0 }), v), json::parser_error);
+        REQUIRE_THROWS_AS(json::msgpack::parse(bytes({}), v), json::parser_error);
+    }
+
+    SECTION("nesting") {
+        json::value v;
+        REQUIRE_THROWS_AS(json::msgpack::parse(std::string(100000, '\x91'), v), json::parser_error);
+        REQUIRE_THROWS_AS(json::msgpack::parse(bytes({ 0x81, 0xa1, 'a', 0x81, 0xa1, 'b', 0xc0 }), v, 1), json::parser_error);
+        REQUIRE_NOTHROW(json::msgpack::parse(bytes({ 0x81, 0xa1, 'a', 0x81, 0xa1, 'b', 0xc0 }), v, 2));
+        REQUIRE(text(v) == "{\"a\":{\"b\":null}}");
+    }
+
+    SECTION("writer") {
+        json::string_sink out;
+        auto w = json::msgpack::make_writer(out);
+        w.begin_object(2);
+        w.key("id").value(1234567);
+        w.key("tags").begin_array(3).value("a").value(true).value(nullptr).end_array();
+        w.end_object();
+        REQUIRE(w.complete());
+        REQUIRE(out.str() == json::msgpack::dump_string(json::object{ { "id", 1234567 }, { "tags", json::array{ "a", true, nullptr } } }));
+    }
+}
+
+TEST_CASE("CBOR", "[cbor]") {
+    SECTION("encoding") {
+        REQUIRE(json::cbor::dump_string(nullptr) == bytes({ 0xf6 }));
+        REQUIRE(json::cbor::dump_string(false) == bytes({ 0xf4 }));
+        REQUIRE(json::cbor::dump_string(23) == bytes({ 0x17 }));
+        REQUIRE(json::cbor::dump_string(24) == bytes({ 0x18, 0x18 }));
+        REQUIRE(json::cbor::dump_string(1000) == bytes({ 0x19, 0x03, 0xe8 }));
+        REQUIRE(json::cbor::dump_string(-1) == bytes({ 0x20 }));
+        REQUIRE(json::cbor::dump_string(-1000) == bytes({ 0x39, 0x03, 0xe7 }));
+        REQUIRE(json::cbor::dump_string(1.5) == bytes({ 0xfa, 0x3f, 0xc0, 0x00, 0x00 }));
+        REQUIRE(json::cbor::dump_string(1.1) == bytes({ 0xfb, 0x3f, 0xf1, 0x99, 0x99, 0x99, 0x99, 0x99, 0x9a }));
+        REQUIRE(json::cbor::dump_string("IETF") == bytes({ 0x64, 'I', 'E', 'T', 'F' }));
+        REQUIRE(json::cbor::dump_string(json::array{ 1, json::array{ 2, 3 } }) == bytes({ 0x82, 0x01, 0x82, 0x02, 0x03 }));
+        REQUIRE(json::cbor::dump_string(json::object{ { "a", 1 } }) == bytes({ 0xa1, 0x61, 'a', 0x01 }));
+    }
+
+    SECTION("decoding") {
+        // examples from appendix A of RFC 7049
+        json::value v;
+        json::cbor::parse(bytes({ 0xf9, 0x3c, 0x00 }), v);
+        REQUIRE(v.as<double>() == 1.0);
+        json::cbor::parse(bytes({ 0xf9, 0xc4, 0x00 }), v);
+        REQUIRE(v.as<double>() == -4.0);
+        json::cbor::parse(bytes({ 0xf9, 0x00, 0x01 }), v);
+        REQUIRE(v.as<double>() == 5.960464477539063e-8);
+        json::cbor::parse(bytes({ 0xf9, 0x7c, 0x00 }), v);
+        REQUIRE(std::isinf(v.as<double>()));
+        json::cbor::parse(bytes({ 0xf7 }), v);
+        REQUIRE(v.is<json::null>());
+        json::cbor::parse(bytes({ 0xc1, 0x1a, 0x51, 0x4b, 0x67, 0xb0 }), v);
+        REQUIRE(v.as<double>() == 1363896240);
+        json::cbor::parse(bytes({ 0x7f, 0x65, 's', 't', 'r', 'e', 'a', 0x64, 'm', 'i', 'n', 'g', 0xff }), v);
+        REQUIRE(v.as<std::string>() == "streaming");
+        json::cbor::parse(bytes({ 0x9f, 0x01, 0x82, 0x02, 0x03, 0x9f, 0x04, 0x05, 0xff, 0xff }), v);
+        REQUIRE(text(v) == "[1,[2,3],[4,5]]");
+        json::cbor::parse(bytes({ 0xbf, 0x61, 'a', 0x01, 0x61, 'b', 0x9f, 0x02, 0x03, 0xff, 0xff }), v);
+        REQUIRE(text(v) == "{\"a\":1,\"b\":[2,3]}");
+        json::cbor::parse(bytes({ 0x3b, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff }), v);
+        REQUIRE(text(v) == "-18446744073709551616");
+    }
+
+    SECTION("round trip") {
+        json::value v = json::object{ { "n", -123456789 }, { "d", 3.14159 }, { "big", 1e300 },
+                                      { "a", json::array{ true, false, nullptr, json::object{} } } };
+        REQUIRE(text(round_trip_cbor(v)) == text(v));
+    }
+
+    SECTION("negative zero") {
+        REQUIRE(std::signbit(round_trip_cbor(-0.0).as<double>()));
+        REQUIRE(!std::signbit(round_trip_cbor(0.0).as<double>()));
+        REQUIRE(json::cbor::dump_string(0.0) == bytes({ 0x00 }));
+    }
+
+    SECTION("invalid") {
+        json::value v;
+        REQUIRE_THROWS_AS(json::cbor::parse(bytes({ 0x1c }), v), json::parser_error);
+        REQUIRE_THROWS_AS(json::cbor::parse(bytes({ 0x9f, 0x01 }), v), json::parser_error);
+        REQUIRE_THROWS_AS(json::cbor::parse(bytes({ 0x7f, 0x41, 'a', 0xff }), v), json::parser_error);
+        REQUIRE_THROWS_AS(json::cbor::parse(bytes({ 0xa1, 0x01, 0x01 }), v), json::parser_error);
+        REQUIRE_THROWS_AS(json::cbor::parse(bytes({ 0x9b, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff }), v), json::parser_error);
+        REQUIRE_THROWS_AS(json::cbor::parse(bytes({ 0xff }), v), json::parser_error);
+    }
+
+    SECTION("nesting") {
+        json::value v;
+        REQUIRE_THROWS_AS(json::cbor::parse(std::string(100000, '\x81'), v), json::parser_error);
+        REQUIRE_THROWS_AS(json::cbor::parse(std::string(100000, '\x9f'), v), json::parser_error);
+        REQUIRE_THROWS_AS(json::cbor::parse(bytes({ 0x81, 0x9f, 0xff }), v, 1), json::parser_error);
+        REQUIRE_NOTHROW(json::cbor::parse(bytes({ 0x81, 0x9f, 0xff }), v, 2));
+
+        // a chain of tags does not nest
+        REQUIRE_NOTHROW(json::cbor::parse(std::string(100000, '\xc1') + bytes({ 0x01 }), v));
+        REQUIRE(v.as<int>() == 1);
+    }
+
+    SECTION("writer") {
+        json::string_sink out;
+        auto w = json::cbor::make_writer(out);
+        w.begin_object();
+        w.key("id").value(1234567);
+        w.key("tags").begin_array(2).value("a").value(false).end_array();
+        w.key("empty").begin_array().end_array();
+        w.end_object();
+        REQUIRE(w.complete());
+        REQUIRE(w.depth() == 0);
+
+        // the object has an indefinite length and is closed by a break
+        REQUIRE(out.str().front() == '\xbf');
+        REQUIRE(out.str().back() == '\xff');
+        json::value v;
+        json::cbor::parse(out.str(), v);
+        REQUIRE(text(v) == "{\"empty\":[],\"id\":1234567,\"tags\":[\"a\",false]}");
+    }
+}
+
+TEST_CASE("binary formats on real data", "[binary-real]") {
+    std::ifstream in("tests/real/twitter.json");
+    REQUIRE(in.is_open());
+    json::value v;
+    json::parse(in, v, json::parse_options::lazy_numbers);
+
+    auto expected = text(v);
+    auto packed = json::msgpack::dump_string(v);
+    auto cbor = json::cbor::dump_string(v);
+    REQUIRE(packed.size() < expected.size());
+    REQUIRE(cbor.size() < expected.size());
+    REQUIRE(text(round_trip_msgpack(v)) == expected);
+    REQUIRE(text(round_trip_cbor(v)) == expected);
+
+    std::ostringstream ss;
+    json::msgpack::dump(ss, v);
+    REQUIRE(ss.str() == packed);
+}
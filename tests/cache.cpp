@@ -0,0 +1,103 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include <catch.hpp>
+#include <jsonpp/cache.hpp>
+#include <thread>
+#include <vector>
+
+TEST_CASE("parse cache", "[cache]") {
+    SECTION("hits share the parsed document") {
+        json::parse_cache cache(4);
+        REQUIRE(cache.capacity() == 4);
+        REQUIRE(cache.size() == 0);
+
+        auto first = cache.parse(R"({"status": "ok"})");
+        auto second = cache.parse(R"({"status": "ok"})");
+        REQUIRE(first);
+        REQUIRE(first.get() == second.get());
+        REQUIRE((*first)["status"].as<std::string>() == "ok");
+        REQUIRE(cache.size() == 1);
+
+        auto other = cache.parse(R"({"status":"ok"})");
+        REQUIRE(other.get() != first.get());
+        REQUIRE(*other == *first);
+        REQUIRE(cache.size() == 2);
+    }
+
+    SECTION("least recently used entries are dropped") {
+        json::parse_cache cache(2);
+        auto a = cache.parse("[1]");
+        auto b = cache.parse("[2]");
+        REQUIRE(cache.parse("[1]").get() == a.get());
+
+        // [2] is now the least recently used
+        cache.parse("[3]");
+        REQUIRE(cache.size() == 2);
+        REQUIRE(cache.parse("[1]").get() == a.get());
+        REQUIRE(cache.parse("[2]").get() != b.get());
+
+        // documents outlive their entries
+        cache.clear();
+        REQUIRE(cache.size() == 0);
+        REQUIRE((*a)[0].as<int>() == 1);
+        REQUIRE((*b)[0].as<int>() == 2);
+    }
+
+    SECTION("errors are not cached") {
+        json::parse_cache cache(2);
+        REQUIRE_THROWS_AS(cache.parse("[1 2]"), json::parser_error);
+        REQUIRE(cache.size() == 0);
+    }
+
+    SECTION("options") {
+        json::parse_cache cache(2, json::parse_options::lazy_numbers);
+        auto doc = cache.parse("[18446744073709551615]");
+        REQUIRE((*doc)[0].as<unsigned long long>() == 18446744073709551615ull);
+    }
+
+    SECTION("concurrent use") {
+        json::parse_cache cache(8);
+        std::vector<std::thread> threads;
+        std::vector<int> failures(4, 0);
+        for(int t = 0; t < 4; ++t) {
+            threads.emplace_back([&cache, &failures, t] {
+                for(int i = 0; i < 1000; ++i) {
+                    int n = (i * 7 + t) % 12;
+                    auto doc = cache.parse("{\"n\": " + std::to_string(n) + "}");
+                    if((*doc)["n"].as<int>() != n) {
+                        ++failures[t];
+                    }
+                }
+            });
+        }
+
+        for(auto&& thread : threads) {
+            thread.join();
+        }
+
+        for(auto&& count : failures) {
+            REQUIRE(count == 0);
+        }
+        REQUIRE(cache.size() == 8);
+    }
+}
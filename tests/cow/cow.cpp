@@ -0,0 +1,98 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <catch.hpp>
+#include <jsonpp/parser.hpp>
+#include <jsonpp/pointer.hpp>
+
+// the tests in this directory are built into their own executable with JSONPP_COPY_ON_WRITE
+// since a program must not mix translation units built with and without it
+
+TEST_CASE("copy on write", "[cow]") {
+    json::value original;
+    json::parse(R"({"list": [1, 2, {"deep": "x"}], "name": "jsonpp"})", original);
+
+    SECTION("copies share until mutated") {
+        json::value copy = original;
+        const json::value& view = copy;
+        REQUIRE(&view.get<json::object>() == &static_cast<const json::value&>(original).get<json::object>());
+
+        copy.get<json::object>()["name"] = "changed";
+        REQUIRE(original["name"].as<std::string>() == "jsonpp");
+        REQUIRE(copy["name"].as<std::string>() == "changed");
+        REQUIRE(&view.get<json::object>() != &static_cast<const json::value&>(original).get<json::object>());
+
+        // the untouched members are still shared
+        REQUIRE(&view["list"].get<json::array>() == &original["list"].get<json::array>());
+    }
+
+    SECTION("nested mutation") {
+        json::value copy = original;
+        auto target = json::pointer("/list/2/deep").resolve(copy);
+        REQUIRE(target != nullptr);
+        *target = 10;
+        REQUIRE(original["list"][2]["deep"].as<std::string>() == "x");
+        REQUIRE(copy["list"][2]["deep"].as<int>() == 10);
+        REQUIRE(original["list"][0].as<int>() == 1);
+    }
+
+    SECTION("lookups do not detach") {
+        json::value copy = original;
+        REQUIRE(copy.find("missing") == nullptr);
+        REQUIRE(json::pointer("/list/9").resolve(static_cast<const json::value&>(copy)) == nullptr);
+        REQUIRE(&static_cast<const json::value&>(copy).get<json::object>() == &static_cast<const json::value&>(original).get<json::object>());
+    }
+
+    SECTION("release") {
+        json::value copy = original;
+        original = nullptr;
+        REQUIRE(copy["list"][2]["deep"].as<std::string>() == "x");
+        json::value moved = std::move(copy);
+        REQUIRE(copy.is<json::null>());
+        REQUIRE(moved["name"].as<std::string>() == "jsonpp");
+    }
+
+    SECTION("references taken before a copy") {
+        const json::value& before = original;
+        auto& name = original.find("name")->get<std::string>();
+        json::value copy = original;
+        name += "!";
+        REQUIRE(before["name"].as<std::string>() == "jsonpp!");
+        REQUIRE(copy["name"].as<std::string>() == "jsonpp");
+
+        // the members that never handed out a reference are still shared
+        const json::value& view = copy;
+        REQUIRE(&view["list"].get<json::array>() == &before["list"].get<json::array>());
+
+        auto& list = original.find("list")->get<json::array>();
+        json::value second = original;
+        list.push_back(4);
+        REQUIRE(before["list"].get<json::array>().size() == 4);
+        REQUIRE(second["list"].get<json::array>().size() == 3);
+    }
+
+    SECTION("shared payloads are measured once") {
+        auto single = original.memory_usage();
+        json::value pair = json::array{ original, original };
+        auto usage = pair.memory_usage();
+        REQUIRE(usage.total() == single.total() + sizeof(json::detail::box<json::array>) + 2 * sizeof(json::value));
+    }
+}
@@ -0,0 +1,77 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <catch.hpp>
+#include <jsonpp/document.hpp>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST_CASE("atomic documents", "[document]") {
+    SECTION("publish and acquire") {
+        json::atomic_document doc;
+        REQUIRE(!doc.acquire());
+
+        doc.publish(json::object{ { "version", 1 } });
+        auto first = doc.acquire();
+        REQUIRE(first);
+        REQUIRE((*first)["version"].as<int>() == 1);
+
+        doc.publish(json::object{ { "version", 2 } });
+        REQUIRE(doc.acquire()->find("version")->as<int>() == 2);
+
+        // old versions stay alive while referenced
+        REQUIRE((*first)["version"].as<int>() == 1);
+        auto copy = first;
+        first = json::document_ref();
+        REQUIRE(!first);
+        REQUIRE((*copy)["version"].as<int>() == 1);
+    }
+
+    SECTION("concurrent readers") {
+        json::atomic_document doc(json::array{ 1, 1 });
+        std::atomic<bool> done(false);
+        std::atomic<int> torn(0);
+        std::vector<std::thread> readers;
+        for(int i = 0; i < 4; ++i) {
+            readers.emplace_back([&] {
+                while(!done) {
+                    auto ref = doc.acquire();
+                    // both elements are written together so a version is never seen half-updated
+                    if((*ref)[0].as<int>() != (*ref)[1].as<int>()) {
+                        ++torn;
+                    }
+                }
+            });
+        }
+
+        for(double i = 1; i <= 2000; ++i) {
+            doc.publish(json::array{ i, i });
+        }
+        done = true;
+        for(auto&& t : readers) {
+            t.join();
+        }
+
+        REQUIRE(torn == 0);
+        REQUIRE((*doc.acquire())[0].as<int>() == 2000);
+    }
+}
@@ -0,0 +1,135 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <catch.hpp>
+#include <jsonpp/parser.hpp>
+#include <fstream>
+#include <sstream>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+TEST_CASE("sinks", "[dump-sinks]") {
+    json::value v;
+    std::ifstream in("tests/real/twitter.json");
+    REQUIRE(in.is_open());
+    REQUIRE_NOTHROW(json::parse(in, v));
+
+    std::ostringstream ss;
+    dump(ss, v);
+    const std::string expected = ss.str();
+
+    SECTION("string sink") {
+        json::string_sink out;
+        dump(out, v);
+        REQUIRE(out.str() == expected);
+        REQUIRE(json::dump_string(v) == expected);
+    }
+
+    SECTION("iterator sink") {
+        std::vector<char> buffer;
+        auto out = json::make_iterator_sink(std::back_inserter(buffer));
+        dump(out, v);
+        REQUIRE(std::string(buffer.begin(), buffer.end()) == expected);
+    }
+}
+
+TEST_CASE("dump formatting", "[dump-format]") {
+    json::format_options minify(0, json::format_options::minify);
+
+    SECTION("indentation") {
+        json::value v = { json::array{ json::array{ 1 } } };
+        REQUIRE(json::dump_string(v, json::format_options(2)) == "[\n  [\n    [\n      1\n    ]\n  ]\n]");
+
+        std::string deep = json::dump_string(v, json::format_options(30));
+        REQUIRE(deep.find("\n" + std::string(90, ' ') + "1\n") != std::string::npos);
+    }
+
+    SECTION("integers") {
+        REQUIRE(json::dump_string(0) == "0");
+        REQUIRE(json::dump_string(1234567890) == "1234567890");
+        REQUIRE(json::dump_string(-42L) == "-42");
+        REQUIRE(json::dump_string(std::numeric_limits<long long>::min()) == "-9223372036854775808");
+        REQUIRE(json::dump_string(std::numeric_limits<unsigned long long>::max()) == "18446744073709551615");
+    }
+
+    SECTION("floating point") {
+        REQUIRE(json::dump_string(1.5, minify) == "1.5");
+        REQUIRE(json::dump_string(1.5, json::format_options(0, json::format_options::fixed, 2)) == "1.50");
+        REQUIRE(json::dump_string(1.5, json::format_options(0, json::format_options::scientific, 2)) == "1.50e+00");
+        REQUIRE(json::dump_string(1e300, json::format_options(0, json::format_options::fixed, 0)).size() == 301);
+        REQUIRE(json::dump_string(std::numeric_limits<double>::quiet_NaN()) == "null");
+    }
+
+    SECTION("shortest round trip") {
+        REQUIRE(json::dump_string(0.1) == "0.1");
+        REQUIRE(json::dump_string(1.0 / 3.0) == "0.3333333333333333");
+        REQUIRE(json::dump_string(-0.0) == "-0");
+        REQUIRE(json::dump_string(100.0) == "100");
+        REQUIRE(json::dump_string(1e16) == "10000000000000000");
+        REQUIRE(json::dump_string(1e17) == "1e+17");
+        REQUIRE(json::dump_string(1e-4) == "0.0001");
+        REQUIRE(json::dump_string(1.5e-5) == "1.5e-05");
+        REQUIRE(json::dump_string(5e-324) == "5e-324");
+        REQUIRE(json::dump_string(std::numeric_limits<double>::max()) == "1.7976931348623157e+308");
+        REQUIRE(json::dump_string(std::numeric_limits<double>::min()) == "2.2250738585072014e-308");
+
+        json::value v;
+        for(double d : { 0.1, 1.0 / 3.0, 2.14567e+101, 123456.789e-300, 9007199254740993.0 }) {
+            REQUIRE_NOTHROW(json::parse(json::dump_string(d), v));
+            REQUIRE(v.as<double>() == d);
+        }
+
+        // an explicit precision is still honoured
+        REQUIRE(json::dump_string(1.0 / 3.0, json::format_options(0, json::format_options::none, 3)) == "0.333");
+    }
+
+    SECTION("strings") {
+        REQUIRE(json::dump_string("plain text") == "\"plain text\"");
+        REQUIRE(json::dump_string("a\"b\\c/d\n") == "\"a\\\"b\\\\c\\/d\\n\"");
+        json::format_options escape(0, json::format_options::escape_multi_byte);
+        REQUIRE(json::dump_string(u8"é\U0001F600", escape) == "\"\\u00e9\\ud83d\\ude00\"");
+        REQUIRE(json::dump_string(std::string(100, 'a') + u8"\u20ac/", escape) == "\"" + std::string(100, 'a') + "\\u20ac\\/\"");
+        REQUIRE(json::dump_string("plain ascii", escape) == "\"plain ascii\"");
+        REQUIRE_THROWS(json::dump_string("\xc3", escape));
+        REQUIRE_THROWS(json::dump_string("\xff\xfe", escape));
+        REQUIRE_THROWS(json::dump_string("\xed\xa0\x80", escape)); // lone surrogate
+    }
+
+    SECTION("long strings") {
+        // escapes at every position of the vectorised and scalar paths
+        for(std::size_t i = 0; i < 70; ++i) {
+            std::string str(70, 'x');
+            str[i] = '"';
+            std::string expected = "\"" + std::string(i, 'x') + "\\\"" + std::string(69 - i, 'x') + "\"";
+            REQUIRE(json::dump_string(str) == expected);
+        }
+
+        std::string clean(1000, 'y');
+        REQUIRE(json::dump_string(clean) == "\"" + clean + "\"");
+        REQUIRE(json::dump_string(clean + "\x7f\xc3\xa9") == "\"" + clean + "\x7f\xc3\xa9\"");
+    }
+
+    SECTION("control characters") {
+        REQUIRE(json::dump_string(std::string("a\x01" "b\x1f")) == "\"a\\u0001b\\u001f\"");
+        REQUIRE(json::dump_string(std::string(1, '\0')) == "\"\\u0000\"");
+    }
+}
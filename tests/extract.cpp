@@ -0,0 +1,154 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <catch.hpp>
+#include <jsonpp/parser.hpp>
+#include <fstream>
+#include <sstream>
+
+TEST_CASE("selectors", "[extract-selectors]") {
+    SECTION("JSON pointer") {
+        json::selector s("/a~1b/0");
+        REQUIRE(s.path().size() == 2);
+        REQUIRE(s.path()[0].token.key == "a/b");
+        REQUIRE(s.path()[1].token.index == 0);
+        REQUIRE(!s.is_multiple());
+    }
+
+    SECTION("JSONPath") {
+        json::selector s("$.statuses[*].user['screen_name']");
+        REQUIRE(s.path().size() == 4);
+        REQUIRE(s.path()[0].token.key == "statuses");
+        REQUIRE(s.path()[1].wildcard);
+        REQUIRE(s.path()[2].token.key == "user");
+        REQUIRE(s.path()[3].token.key == "screen_name");
+        REQUIRE(s.is_multiple());
+
+        json::selector t("$[1].*");
+        REQUIRE(t.path().size() == 2);
+        REQUIRE(t.path()[0].token.index == 1);
+        REQUIRE(t.path()[1].wildcard);
+
+        REQUIRE(json::selector("$").path().empty());
+    }
+
+    SECTION("invalid") {
+        REQUIRE_THROWS(json::selector("$.."));
+        REQUIRE_THROWS(json::selector("$[abc]"));
+        REQUIRE_THROWS(json::selector("$['abc'"));
+        REQUIRE_THROWS(json::selector("$x"));
+        REQUIRE_THROWS(json::selector("abc"));
+    }
+}
+
+TEST_CASE("extraction", "[extract]") {
+    std::string doc = R"({
+        "skipped": { "nested": [1, 2, { "deep": "\"}]" }], "x": true },
+        "level": "warn",
+        "tags": ["a", "b", "c"],
+        "ctx": { "host": "db1", "pid": 1234, "extra": [null, 1.5e3] }
+    })";
+
+    SECTION("single matches") {
+        auto&& result = json::extract(doc, { "/level", "/ctx/pid", "/tags/1", "/missing", "/ctx/extra/1" });
+        REQUIRE(result.size() == 5);
+        REQUIRE(result[0].as<std::string>() == "warn");
+        REQUIRE(result[1].as<int>() == 1234);
+        REQUIRE(result[2].as<std::string>() == "b");
+        REQUIRE(result[3].is<json::null>());
+        REQUIRE(result[4].as<double>() == 1500.0);
+    }
+
+    SECTION("overlapping matches") {
+        auto&& result = json::extract(doc, { "/ctx", "/ctx/host", "$.ctx.*" });
+        REQUIRE(result[0].is<json::object>());
+        REQUIRE(result[0]["host"].as<std::string>() == "db1");
+        REQUIRE(result[1].as<std::string>() == "db1");
+        REQUIRE(result[2].is<json::array>());
+        REQUIRE(result[2].get<json::array>().size() == 3);
+    }
+
+    SECTION("wildcards") {
+        auto&& result = json::extract(doc, { "$.tags[*]", "$.nothing[*]" });
+        REQUIRE(result[0].get<json::array>().size() == 3);
+        REQUIRE(result[0][2].as<std::string>() == "c");
+        REQUIRE(result[1].get<json::array>().empty());
+    }
+
+    SECTION("whole document") {
+        auto&& result = json::extract(doc, { "" });
+        json::value v;
+        json::parse(doc, v);
+        REQUIRE(json::dump_string(result[0]) == json::dump_string(v));
+    }
+
+    SECTION("invalid") {
+        REQUIRE_THROWS(json::extract("{\"a\": [1, 2}", { "/b" }));
+        REQUIRE_THROWS(json::extract("{\"a\": \"unterminated}", { "/b" }));
+        REQUIRE_THROWS(json::extract("{\"a\": 1} x", { "/a" }));
+        REQUIRE_THROWS(json::extract("{\"a\" 1}", { "/a" }));
+        REQUIRE_THROWS(json::extract("[1 2]", { "/0" }));
+        REQUIRE_THROWS_AS(json::extract(R"({"a": 1,})", { "/a" }), json::parser_error);
+        REQUIRE_THROWS_AS(json::extract(R"({"a": {"b": 1,}})", { "/a/b" }), json::parser_error);
+    }
+
+    SECTION("skipped values are checked") {
+        // everything parse rejects is rejected even where no selector looks
+        const char* malformed[] = {
+            R"({"a": {"b": 1,}, "c": 2})",
+            R"({"a": [1, 2,], "c": 2})",
+            R"({"a": [1 2], "c": 2})",
+            R"({"a": {"b" 1}, "c": 2})",
+            R"({"a": {1: 2}, "c": 2})",
+            R"({"a": [}, "c": 2})",
+            R"({"a": tru, "c": 2})",
+            R"({"a": nul, "c": 2})",
+            R"({"a": 1x, "c": 2})",
+            R"({"a": "\q", "c": 2})",
+            R"({"a": "\u12", "c": 2})",
+            R"({"a": "\ud83d", "c": 2})",
+            R"({"a": @, "c": 2})",
+            R"({"a": [1, )"
+        };
+        for(auto&& text : malformed) {
+            INFO(text);
+            json::value v;
+            REQUIRE_THROWS_AS(json::parse(text, v), json::parser_error);
+            REQUIRE_THROWS_AS(json::extract(text, { "/c" }), json::parser_error);
+        }
+
+        auto&& result = json::extract(R"({"a": {"b": [1, "\u00e9\ud83d\ude00\n", -2.5e3, true, null, {}]}, "c": 2})", { "/c" });
+        REQUIRE(result[0].as<int>() == 2);
+    }
+}
+
+TEST_CASE("extraction from twitter response", "[extract-real]") {
+    std::ifstream in("tests/real/twitter.json");
+    REQUIRE(in.is_open());
+    std::ostringstream ss;
+    ss << in.rdbuf();
+
+    auto&& result = json::extract(ss.str(), { "/0/user/name", "$[*].id_str", "/1/geo" });
+    REQUIRE(result[0].as<std::string>() == "OAuth Dancer");
+    REQUIRE(result[1].get<json::array>().size() == 3);
+    REQUIRE(result[1][0].as<std::string>() == "240558470661799936");
+    REQUIRE(result[2].is<json::object>());
+}
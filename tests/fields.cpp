@@ -0,0 +1,165 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <catch.hpp>
+#include <jsonpp/value.hpp>
+#include <jsonpp/writer.hpp>
+#include <jsonpp/parser.hpp>
+#include <sstream>
+#include <vector>
+#include <map>
+
+namespace app {
+struct address {
+    std::string city;
+    int zip;
+};
+
+JSONPP_FIELDS(address, city, zip)
+
+struct person {
+    std::string name;
+    double height;
+    bool admin;
+    address home;
+    std::vector<address> previous;
+    std::map<std::string, int> scores;
+};
+
+JSONPP_FIELDS(person, name, height, admin, home, previous, scores)
+
+struct empty {};
+} // app
+
+namespace {
+app::person make_person() {
+    return { "Bob", 1.75, false, { "Paris", 75001 }, { { "Lyon", 69001 }, { "Nice", 6000 } }, { { "chess", 3 } } };
+}
+} // anonymous namespace
+
+TEST_CASE("member descriptions", "[fields]") {
+    json::format_options minify(0, json::format_options::minify);
+    const auto bob = make_person();
+
+    SECTION("traits") {
+        REQUIRE(json::has_fields<app::person>::value);
+        REQUIRE(json::has_fields<app::address>::value);
+        REQUIRE(!json::has_fields<app::empty>::value);
+        REQUIRE(!json::has_fields<int>::value);
+    }
+
+    SECTION("minified") {
+        std::ostringstream ss;
+        json::dump(ss, bob, minify);
+        REQUIRE(ss.str() == "{\"name\":\"Bob\",\"height\":1.75,\"admin\":false,\"home\":{\"city\":\"Paris\",\"zip\":75001},"
+                            "\"previous\":[{\"city\":\"Lyon\",\"zip\":69001},{\"city\":\"Nice\",\"zip\":6000}],"
+                            "\"scores\":{\"chess\":3}}");
+        REQUIRE(json::dump_string(bob, minify) == ss.str());
+    }
+
+    SECTION("pretty") {
+        REQUIRE(json::dump_string(app::address{ "Paris", 75001 }, json::format_options(2)) ==
+                "{\n  \"city\": \"Paris\",\n  \"zip\": 75001\n}");
+    }
+
+    SECTION("writer") {
+        json::string_sink out;
+        auto w = json::make_writer(out, minify);
+        w.begin_array().value(bob.home).value(bob.previous).end_array();
+        REQUIRE(out.str() == "[{\"city\":\"Paris\",\"zip\":75001},[{\"city\":\"Lyon\",\"zip\":69001},{\"city\":\"Nice\",\"zip\":6000}]]");
+    }
+}
+
+TEST_CASE("typed parsing", "[fields-parse]") {
+    json::format_options minify(0, json::format_options::minify);
+
+    SECTION("round trip") {
+        const auto bob = make_person();
+        app::person result;
+        json::parse(json::dump_string(bob), result);
+        REQUIRE(json::dump_string(result, minify) == json::dump_string(bob, minify));
+    }
+
+    SECTION("member order and unknown keys") {
+        app::person result;
+        result.height = 2;
+        json::parse(R"({"home": {"zip": 10, "extra": [1, {"a": "}"}], "city": "Ro\"me"}, "admin": true,)"
+                    R"( "name": "Al", "unknown": null, "previous": [], "scores": {"x": -1, "y": 2}})", result);
+        REQUIRE(result.name == "Al");
+        REQUIRE(result.height == 2);
+        REQUIRE(result.admin);
+        REQUIRE(result.home.city == "Ro\"me");
+        REQUIRE(result.home.zip == 10);
+        REQUIRE(result.previous.empty());
+        REQUIRE(result.scores.size() == 2);
+        REQUIRE(result.scores["x"] == -1);
+    }
+
+    SECTION("escaped keys") {
+        app::address result;
+        json::parse(R"({"ci\u0074y": "Oslo", "zi\u0070": 150})", result);
+        REQUIRE(result.city == "Oslo");
+        REQUIRE(result.zip == 150);
+    }
+
+    SECTION("containers and values") {
+        std::vector<std::map<std::string, json::value>> result;
+        json::parse(R"([{"a": [1, 2]}, {}])", result);
+        REQUIRE(result.size() == 2);
+        REQUIRE(result[0]["a"].is<json::array>());
+        REQUIRE(result[1].empty());
+
+        std::vector<long long> numbers;
+        json::parse("[9007199254740993, -5]", numbers);
+        REQUIRE(numbers[0] == 9007199254740993LL);
+        REQUIRE(numbers[1] == -5);
+    }
+
+    SECTION("type mismatches") {
+        app::address result;
+        REQUIRE_THROWS_AS(json::parse(R"({"city": 10})", result), json::parser_error);
+        REQUIRE_THROWS_AS(json::parse(R"({"zip": "10"})", result), json::parser_error);
+        REQUIRE_THROWS_AS(json::parse(R"([])", result), json::parser_error);
+        REQUIRE_THROWS_AS(json::parse(R"({"zip": 10} 1)", result), json::parser_error);
+
+        std::vector<int> numbers;
+        REQUIRE_THROWS_AS(json::parse("[1, 2,]", numbers), json::parser_error);
+        REQUIRE_THROWS_AS(json::parse("[1 2]", numbers), json::parser_error);
+    }
+
+    SECTION("malformed objects") {
+        app::address result;
+        REQUIRE_THROWS_AS(json::parse(R"({"city": "Oslo",})", result), json::parser_error);
+        REQUIRE_THROWS_AS(json::parse(R"({"city": "Oslo", })", result), json::parser_error);
+
+        std::map<std::string, int> scores;
+        REQUIRE_THROWS_AS(json::parse(R"({"x": 1,})", scores), json::parser_error);
+
+        // unknown keys are skipped but still have to hold valid JSON
+        REQUIRE_THROWS_AS(json::parse(R"({"extra": [1, 2,], "zip": 1})", result), json::parser_error);
+        REQUIRE_THROWS_AS(json::parse(R"({"extra": {"a": 1,}, "zip": 1})", result), json::parser_error);
+        REQUIRE_THROWS_AS(json::parse(R"({"extra": [1 2], "zip": 1})", result), json::parser_error);
+        REQUIRE_THROWS_AS(json::parse(R"({"extra": nope, "zip": 1})", result), json::parser_error);
+        REQUIRE_THROWS_AS(json::parse(R"({"extra": "\x", "zip": 1})", result), json::parser_error);
+        REQUIRE_NOTHROW(json::parse(R"({"extra": [1, {"a": "\"}\\"}, null], "zip": 1})", result));
+        REQUIRE(result.zip == 1);
+    }
+}
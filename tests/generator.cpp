@@ -0,0 +1,122 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include <catch.hpp>
+#include <jsonpp/generator.hpp>
+#include <jsonpp/parser.hpp>
+
+namespace {
+unsigned max_depth(const json::value& v) {
+    unsigned result = 0;
+    if(v.is<json::array>()) {
+        for(auto&& elem : v.get<json::array>()) {
+            result = std::max(result, max_depth(elem) + 1);
+        }
+        return std::max(result, 1u);
+    }
+
+    if(v.is<json::object>()) {
+        for(auto&& member : v.get<json::object>()) {
+            result = std::max(result, max_depth(member.second) + 1);
+        }
+        return std::max(result, 1u);
+    }
+    return 0;
+}
+
+// parses the generated text and checks it survives a round trip
+json::value parse_generated(const json::generator_options& opt) {
+    auto text = json::generate_string(opt);
+    json::value v;
+    REQUIRE_NOTHROW(json::parse(text, v));
+
+    json::value again;
+    json::parse(json::dump_string(v), again);
+    REQUIRE(v == again);
+    return v;
+}
+} // anonymous namespace
+
+TEST_CASE("synthetic documents", "[generator]") {
+    SECTION("deterministic") {
+        json::generator_options opt;
+        REQUIRE(json::generate_string(opt) == json::generate_string(opt));
+
+        auto other = opt;
+        other.seed = 2;
+        REQUIRE(json::generate_string(opt) != json::generate_string(other));
+    }
+
+    SECTION("shape") {
+        json::generator_options opt;
+        opt.depth = 1;
+        opt.width = 5;
+        auto v = parse_generated(opt);
+        REQUIRE(v.is<json::object>());
+        REQUIRE(v.get<json::object>().size() == 5);
+        REQUIRE(max_depth(v) == 1);
+
+        opt.depth = 0;
+        REQUIRE(!parse_generated(opt).is<json::object>());
+
+        opt.depth = 6;
+        opt.container_ratio = 1;
+        opt.width = 2;
+        opt.length = 3;
+        REQUIRE(max_depth(parse_generated(opt)) == 6);
+
+        opt.string_ratio = 1;
+        opt.container_ratio = 0;
+        opt.escape_ratio = 0;
+        opt.depth = 1;
+        auto strings = parse_generated(opt);
+        for(auto&& member : strings.get<json::object>()) {
+            REQUIRE(member.second.is<std::string>());
+        }
+        REQUIRE(json::generate_string(opt).find('\\') == std::string::npos);
+    }
+
+    SECTION("size") {
+        json::generator_options opt;
+        opt.size = 100000;
+        auto text = json::generate_string(opt);
+        REQUIRE(text.size() >= opt.size);
+        REQUIRE(text.size() < opt.size + 20000);
+        REQUIRE(parse_generated(opt).is<json::array>());
+    }
+
+    SECTION("sweep") {
+        json::generator_options opt;
+        for(unsigned depth : { 0, 1, 3, 8 }) {
+            for(double escapes : { 0.0, 0.1, 1.0 }) {
+                for(int numbers = 0; numbers <= json::generator_options::mixed; ++numbers) {
+                    opt.seed = depth * 1000 + static_cast<unsigned>(numbers);
+                    opt.depth = depth;
+                    opt.escape_ratio = escapes;
+                    opt.numbers = static_cast<json::generator_options::number_distribution>(numbers);
+                    opt.string_ratio = 0.3;
+                    parse_generated(opt);
+                }
+            }
+        }
+    }
+}
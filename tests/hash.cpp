@@ -0,0 +1,96 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <catch.hpp>
+#include <jsonpp/parser.hpp>
+#include <unordered_set>
+
+namespace {
+json::value from(const char* str, json::parse_options opt = {}) {
+    json::value result;
+    json::parse(str, result, opt);
+    return result;
+}
+} // anonymous namespace
+
+TEST_CASE("equality", "[equality]") {
+    REQUIRE(json::value() == json::value(nullptr));
+    REQUIRE(json::value(1.0) == json::value(1));
+    REQUIRE(json::value(-0.0) == json::value(0.0));
+    REQUIRE(json::value(true) != json::value(1));
+    REQUIRE(json::value("1") != json::value(1));
+    REQUIRE(json::value("abc") == json::value(std::string("abc")));
+    REQUIRE(from("[1, [2, {}]]") == from("[1.0, [2e0, {}]]"));
+    REQUIRE(from("[1, 2]") != from("[1, 2, 3]"));
+    REQUIRE(from("[1, 2]") != from("[2, 1]"));
+    REQUIRE(from(R"({"a": 1, "b": [true]})") == from(R"({"b": [true], "a": 1})"));
+    REQUIRE(from(R"({"a": 1})") != from(R"({"b": 1})"));
+    REQUIRE(from(R"({"a": null})") != from("{}"));
+    REQUIRE(from("10", json::parse_options::lazy_numbers) == from("1e1"));
+}
+
+TEST_CASE("hashing", "[hash]") {
+    SECTION("equal values hash equally") {
+        REQUIRE(json::value(1.0).hash() == json::value(1).hash());
+        REQUIRE(json::value(-0.0).hash() == json::value(0.0).hash());
+        REQUIRE(from(R"({"a": 1, "b": [true]})").hash() == from(R"({"b": [true], "a": 1.0})").hash());
+        REQUIRE(from("100", json::parse_options::lazy_numbers).hash() == from("1e2").hash());
+    }
+
+    SECTION("different values usually hash differently") {
+        std::unordered_set<std::uint64_t> hashes;
+        const char* documents[] = {
+            "null", "true", "false", "0", "1", "\"\"", "\"0\"", "[]", "{}", "[null]", "[[]]", "[{}]",
+            "[1, 2]", "[2, 1]", R"({"a": 1})", R"({"a": 2})", R"({"b": 1})", R"({"a": 1, "b": 2})",
+            R"({"a": 2, "b": 1})", R"("12345678")", R"("123456789")", R"(["a", "b"])", R"(["ab"])"
+        };
+
+        for(auto&& doc : documents) {
+            hashes.insert(from(doc).hash());
+        }
+        REQUIRE(hashes.size() == sizeof(documents) / sizeof(documents[0]));
+    }
+
+    SECTION("memoization") {
+        auto doc = from(R"({"list": [1, 2, 3], "name": "jsonpp"})");
+        auto plain = doc.hash();
+        REQUIRE(doc.hash(true) == plain);
+        REQUIRE(doc.hash(true) == plain);
+
+        doc.get<json::object>()["list"].get<json::array>().push_back(4);
+        REQUIRE(doc.hash(true) == doc.hash());
+        REQUIRE(doc.hash(true) != plain);
+
+        auto other = from(R"({"list": [1, 2, 3, 4], "name": "jsonpp"})");
+        other.hash(true);
+        REQUIRE(doc == other);
+        other.get<json::object>()["name"] = "other";
+        REQUIRE(doc != other);
+    }
+
+    SECTION("hash containers") {
+        std::unordered_set<json::value> events;
+        REQUIRE(events.insert(from(R"({"id": 1, "kind": "click"})")).second);
+        REQUIRE(!events.insert(from(R"({"kind": "click", "id": 1})")).second);
+        REQUIRE(events.insert(from(R"({"id": 2, "kind": "click"})")).second);
+        REQUIRE(events.size() == 2);
+    }
+}
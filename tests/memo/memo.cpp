@@ -0,0 +1,79 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <catch.hpp>
+#include <jsonpp/parser.hpp>
+
+// the tests in this directory are built into their own executable with JSONPP_MEMOIZE_HASH
+// since the macro changes the layout of json::value
+
+namespace {
+json::value from(const char* str) {
+    json::value result;
+    json::parse(str, result);
+    return result;
+}
+
+// compares with both hashes memoized so that stale ones would make equal values unequal
+bool equal_hashed(const json::value& lhs, const char* rhs) {
+    auto other = from(rhs);
+    other.hash(true);
+    lhs.hash(true);
+    return lhs == other && lhs.hash(true) == other.hash() && lhs.hash() == other.hash(true);
+}
+} // anonymous namespace
+
+TEST_CASE("memoized hashes are cleared by mutable access", "[memo]") {
+    const char* original = R"({"inner": {"k": "v"}, "list": [1, 2, 3], "name": "jsonpp"})";
+    auto doc = from(original);
+    REQUIRE(equal_hashed(doc, original));
+
+    SECTION("get") {
+        doc.get<json::object>()["name"] = "other";
+        REQUIRE(!equal_hashed(doc, original));
+        REQUIRE(equal_hashed(doc, R"({"inner": {"k": "v"}, "list": [1, 2, 3], "name": "other"})"));
+    }
+
+    SECTION("references") {
+        auto& list = doc.get<json::object>()["list"].get<json::array>();
+        list.push_back(4);
+        list[0] = 0.0;
+        REQUIRE(equal_hashed(doc, R"({"inner": {"k": "v"}, "list": [0, 2, 3, 4], "name": "jsonpp"})"));
+
+        auto& inner = doc.get<json::object>()["inner"];
+        inner.get<json::object>()["k"].get<std::string>() += "w";
+        REQUIRE(equal_hashed(doc, R"({"inner": {"k": "vw"}, "list": [0, 2, 3, 4], "name": "jsonpp"})"));
+    }
+
+    SECTION("find") {
+        doc.find("inner")->find("k")->get<std::string>() = "w";
+        REQUIRE(equal_hashed(doc, R"({"inner": {"k": "w"}, "list": [1, 2, 3], "name": "jsonpp"})"));
+
+        doc.find("list")->get_if<json::array>()->pop_back();
+        REQUIRE(equal_hashed(doc, R"({"inner": {"k": "w"}, "list": [1, 2], "name": "jsonpp"})"));
+    }
+
+    SECTION("lookups that find nothing") {
+        REQUIRE(doc.find("missing") == nullptr);
+        REQUIRE(doc.get_if<json::array>() == nullptr);
+        REQUIRE(equal_hashed(doc, original));
+    }
+}
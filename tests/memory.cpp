@@ -0,0 +1,97 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include <catch.hpp>
+#include <jsonpp/parser.hpp>
+#include <fstream>
+#include <sstream>
+
+TEST_CASE("memory usage", "[memory]") {
+    using box_size = std::integral_constant<std::size_t, sizeof(json::detail::box<std::string>)>;
+
+    SECTION("scalars live inline") {
+        REQUIRE(json::value().memory_usage().total() == 0);
+        REQUIRE(json::value(true).memory_usage().total() == 0);
+        REQUIRE(json::value(10).memory_usage().allocations == 0);
+    }
+
+    SECTION("strings") {
+        auto small = json::value("abc").memory_usage();
+        REQUIRE(small.allocations == 1);
+        REQUIRE(small.boxes == box_size::value);
+        REQUIRE(small.strings == 0);
+
+        std::string text(100, 'x');
+        text.reserve(150);
+        auto large = json::value(text).memory_usage();
+        REQUIRE(large.allocations == 2);
+        REQUIRE(large.strings > 100);
+        REQUIRE(large.string_slack == large.strings - 101);
+        REQUIRE(large.total() == large.boxes + large.strings);
+    }
+
+    SECTION("arrays and objects") {
+        json::value arr = json::array{ 1, 2 };
+        arr.get<json::array>().reserve(10);
+        auto capacity = arr.get<json::array>().capacity();
+        auto usage = arr.memory_usage();
+        REQUIRE(usage.arrays == capacity * sizeof(json::value));
+        REQUIRE(usage.array_slack == (capacity - 2) * sizeof(json::value));
+        REQUIRE(usage.slack() == usage.array_slack);
+
+        json::value obj = json::object{ { "a", 1 }, { std::string(40, 'k'), "v" } };
+        usage = obj.memory_usage();
+        REQUIRE(usage.objects >= 2 * sizeof(json::object::value_type));
+        REQUIRE(usage.strings > 40);
+        // the object box, two nodes, the long key and the box of "v"
+        REQUIRE(usage.allocations == 5);
+    }
+
+    SECTION("lazy numbers") {
+        json::value doc;
+        json::parse("[1, 2.5, 1234567890123456789]", doc, json::parse_options::lazy_numbers);
+        auto usage = doc.memory_usage();
+        REQUIRE(usage.numbers == json::detail::number_arena::entry_size(1) +
+                                 json::detail::number_arena::entry_size(3) +
+                                 json::detail::number_arena::entry_size(19));
+        // the digits share the blocks of their parse, so only the box and the elements are allocated
+        REQUIRE(usage.allocations == 2);
+        REQUIRE(json::value(json::raw_number, "10").memory_usage().numbers == json::detail::number_arena::entry_size(2));
+    }
+
+    SECTION("documents") {
+        std::ifstream in("tests/real/twitter.json");
+        std::stringstream ss;
+        ss << in.rdbuf();
+        json::value doc;
+        json::parse(ss.str(), doc);
+
+        auto usage = doc.memory_usage();
+        REQUIRE(usage.total() > ss.str().size());
+        REQUIRE(usage.total() == usage.boxes + usage.strings + usage.arrays + usage.objects);
+
+        // copies do not keep the slack of the original
+        auto copy = json::value(doc).memory_usage();
+        REQUIRE(copy.allocations == usage.allocations);
+        REQUIRE(copy.slack() <= usage.slack());
+    }
+}
@@ -0,0 +1,212 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <catch.hpp>
+#include <jsonpp/patch.hpp>
+#include <jsonpp/parser.hpp>
+
+namespace {
+json::value from(const char* str) {
+    json::value result;
+    json::parse(str, result);
+    return result;
+}
+
+std::string text(const json::value& v) {
+    return json::dump_string(v, json::format_options(0, json::format_options::minify));
+}
+
+std::string patched(const char* doc, const char* patch) {
+    auto result = from(doc);
+    json::apply_patch(result, from(patch));
+    return text(result);
+}
+
+std::string diffed(const char* lhs, const char* rhs) {
+    auto result = from(lhs);
+    auto target = from(rhs);
+    json::apply_patch(result, json::diff(result, target));
+    REQUIRE(result == target);
+    return text(json::diff(from(lhs), target));
+}
+
+std::string merged(const char* doc, const char* patch) {
+    auto result = from(doc);
+    json::apply_merge_patch(result, from(patch));
+    return text(result);
+}
+} // anonymous namespace
+
+TEST_CASE("JSON Patch", "[patch]") {
+    // examples from appendix A of RFC 6902
+    SECTION("operations") {
+        REQUIRE(patched(R"({"foo": "bar"})", R"([{"op": "add", "path": "/baz", "value": "qux"}])") == R"({"baz":"qux","foo":"bar"})");
+        REQUIRE(patched(R"({"foo": ["bar", "baz"]})", R"([{"op": "add", "path": "/foo/1", "value": "qux"}])") == R"({"foo":["bar","qux","baz"]})");
+        REQUIRE(patched(R"({"foo": ["bar"]})", R"([{"op": "add", "path": "/foo/-", "value": ["abc"]}])") == R"({"foo":["bar",["abc"]]})");
+        REQUIRE(patched(R"({"baz": "qux", "foo": "bar"})", R"([{"op": "remove", "path": "/baz"}])") == R"({"foo":"bar"})");
+        REQUIRE(patched(R"({"foo": ["bar", "qux", "baz"]})", R"([{"op": "remove", "path": "/foo/1"}])") == R"({"foo":["bar","baz"]})");
+        REQUIRE(patched(R"({"baz": "qux", "foo": "bar"})", R"([{"op": "replace", "path": "/baz", "value": "boo"}])") == R"({"baz":"boo","foo":"bar"})");
+        REQUIRE(patched(R"({"foo": {"bar": "baz", "waldo": "fred"}, "qux": {"corge": "grault"}})",
+                        R"([{"op": "move", "from": "/foo/waldo", "path": "/qux/thud"}])") ==
+                R"({"foo":{"bar":"baz"},"qux":{"corge":"grault","thud":"fred"}})");
+        REQUIRE(patched(R"({"foo": ["all", "grass", "cows", "eat"]})", R"([{"op": "move", "from": "/foo/1", "path": "/foo/3"}])") ==
+                R"({"foo":["all","cows","eat","grass"]})");
+        REQUIRE(patched(R"({"foo": {"a": 1}})", R"([{"op": "copy", "from": "/foo", "path": "/bar"}])") == R"({"bar":{"a":1},"foo":{"a":1}})");
+        REQUIRE(patched(R"({"baz": "qux", "foo": ["a", 2, "c"]})",
+                        R"([{"op": "test", "path": "/baz", "value": "qux"}, {"op": "test", "path": "/foo/1", "value": 2}])") ==
+                R"({"baz":"qux","foo":["a",2,"c"]})");
+        REQUIRE(patched(R"({"foo": 1})", R"([{"op": "replace", "path": "", "value": [1]}])") == "[1]");
+        REQUIRE(patched(R"({"/": 1})", R"([{"op": "remove", "path": "/~1"}])") == "{}");
+    }
+
+    SECTION("errors") {
+        auto doc = from(R"({"foo": "bar", "list": [1, 2]})");
+        REQUIRE_THROWS_AS(json::apply_patch(doc, from(R"([{"op": "add", "path": "/baz/bat", "value": "qux"}])")), json::patch_error);
+        REQUIRE_THROWS_AS(json::apply_patch(doc, from(R"([{"op": "test", "path": "/foo", "value": "baz"}])")), json::patch_error);
+        REQUIRE_THROWS_AS(json::apply_patch(doc, from(R"([{"op": "remove", "path": "/list/2"}])")), json::patch_error);
+        REQUIRE_THROWS_AS(json::apply_patch(doc, from(R"([{"op": "add", "path": "/list/3", "value": 1}])")), json::patch_error);
+        REQUIRE_THROWS_AS(json::apply_patch(doc, from(R"([{"op": "move", "from": "/list", "path": "/list/0"}])")), json::patch_error);
+        REQUIRE_THROWS_AS(json::apply_patch(doc, from(R"([{"op": "frobnicate", "path": "/foo"}])")), json::patch_error);
+        REQUIRE_THROWS_AS(json::apply_patch(doc, from(R"([{"op": "add", "path": "foo", "value": 1}])")), json::patch_error);
+        REQUIRE_THROWS_AS(json::apply_patch(doc, from(R"([{"op": "add", "path": "/foo"}])")), json::patch_error);
+        REQUIRE_THROWS_AS(json::apply_patch(doc, from(R"({"op": "add"})")), json::patch_error);
+        REQUIRE(text(doc) == R"({"foo":"bar","list":[1,2]})");
+
+        try {
+            json::apply_patch(doc, from(R"([{"op": "test", "path": "/foo", "value": "bar"}, {"op": "remove", "path": "/nope"}])"));
+            FAIL("expected an error");
+        }
+        catch(const json::patch_error& e) {
+            REQUIRE(std::string(e.what()).find("patch operation 1") == 0);
+        }
+    }
+
+    SECTION("rollback") {
+        const char* original = R"({"a": {"b": [1, 2, 3]}, "c": "d", "e": {"f": null}})";
+        auto doc = from(original);
+        REQUIRE_THROWS_AS(json::apply_patch(doc, from(R"([
+            {"op": "add", "path": "/a/b/-", "value": 4},
+            {"op": "remove", "path": "/a/b/0"},
+            {"op": "replace", "path": "/c", "value": {"x": 1}},
+            {"op": "move", "from": "/e", "path": "/c/x"},
+            {"op": "move", "from": "/a/b/1", "path": "/a/b/0"},
+            {"op": "copy", "from": "/a", "path": "/a/b/0"},
+            {"op": "add", "path": "", "value": {"a": []}},
+            {"op": "add", "path": "/a/-", "value": 1},
+            {"op": "test", "path": "/a/0", "value": 2}
+        ])")), json::patch_error);
+        REQUIRE(text(doc) == text(from(original)));
+    }
+
+    SECTION("failed moves") {
+        const char* original = R"({"a": {"x": [1, 2, 3]}, "arr": [1, 2], "k": "v"})";
+        auto doc = from(original);
+        REQUIRE_THROWS_AS(json::apply_patch(doc, from(R"([{"op": "move", "from": "/a/x", "path": "/missing/y"}])")), json::patch_error);
+        REQUIRE(text(doc) == text(from(original)));
+        REQUIRE_THROWS_AS(json::apply_patch(doc, from(R"([{"op": "move", "from": "/k", "path": "/arr/5"}])")), json::patch_error);
+        REQUIRE(text(doc) == text(from(original)));
+        REQUIRE_THROWS_AS(json::apply_patch(doc, from(R"([
+            {"op": "remove", "path": "/arr/0"},
+            {"op": "move", "from": "/arr/0", "path": "/k/z"}
+        ])")), json::patch_error);
+        REQUIRE(text(doc) == text(from(original)));
+    }
+}
+
+TEST_CASE("JSON Merge Patch", "[merge-patch]") {
+    // examples from appendix A of RFC 7396
+    REQUIRE(merged(R"({"a": "b"})", R"({"a": "c"})") == R"({"a":"c"})");
+    REQUIRE(merged(R"({"a": "b"})", R"({"b": "c"})") == R"({"a":"b","b":"c"})");
+    REQUIRE(merged(R"({"a": "b"})", R"({"a": null})") == "{}");
+    REQUIRE(merged(R"({"a": "b", "b": "c"})", R"({"a": null})") == R"({"b":"c"})");
+    REQUIRE(merged(R"({"a": ["b"]})", R"({"a": "c"})") == R"({"a":"c"})");
+    REQUIRE(merged(R"({"a": "c"})", R"({"a": ["b"]})") == R"({"a":["b"]})");
+    REQUIRE(merged(R"({"a": {"b": "c"}})", R"({"a": {"b": "d", "c": null}})") == R"({"a":{"b":"d"}})");
+    REQUIRE(merged(R"({"a": [{"b": "c"}]})", R"({"a": [1]})") == R"({"a":[1]})");
+    REQUIRE(merged(R"(["a", "b"])", R"(["c", "d"])") == R"(["c","d"])");
+    REQUIRE(merged(R"({"a": "b"})", R"(["c"])") == R"(["c"])");
+    REQUIRE(merged(R"({"a": "foo"})", "null") == "null");
+    REQUIRE(merged(R"({"e": null})", R"({"a": 1})") == R"({"a":1,"e":null})");
+    REQUIRE(merged(R"([1, 2])", R"({"a": "b", "c": null})") == R"({"a":"b"})");
+    REQUIRE(merged("{}", R"({"a": {"bb": {"ccc": null}}})") == R"({"a":{"bb":{}}})");
+}
+
+TEST_CASE("JSON diff", "[diff]") {
+    SECTION("scalars and objects") {
+        REQUIRE(diffed("1", "1") == "[]");
+        REQUIRE(diffed("1", "2") == R"([{"op":"replace","path":"","value":2}])");
+        REQUIRE(diffed("[1]", R"({"a":1})") == R"([{"op":"replace","path":"","value":{"a":1}}])");
+        REQUIRE(diffed(R"({"a":1,"b":{"c":[1,2]}})", R"({"a":1,"b":{"c":[1,2]}})") == "[]");
+        REQUIRE(diffed(R"({"a":1,"b":2})", R"({"b":3,"c":4})") ==
+                R"([{"op":"remove","path":"\/a"},{"op":"replace","path":"\/b","value":3},{"op":"add","path":"\/c","value":4}])");
+        REQUIRE(diffed(R"({"a/b":{"m~n":1}})", R"({"a/b":{"m~n":2}})") ==
+                R"([{"op":"replace","path":"\/a~1b\/m~0n","value":2}])");
+    }
+
+    SECTION("arrays") {
+        REQUIRE(diffed("[1,2,3]", "[1,2,3,4]") == R"([{"op":"add","path":"\/3","value":4}])");
+        REQUIRE(diffed("[1,2,3]", "[0,1,2,3]") == R"([{"op":"add","path":"\/0","value":0}])");
+        REQUIRE(diffed("[1,2,3]", "[1,3]") == R"([{"op":"remove","path":"\/1"}])");
+        REQUIRE(diffed("[1,2,3,4,5]", "[1,9,3,5]") ==
+                R"([{"op":"replace","path":"\/1","value":9},{"op":"remove","path":"\/3"}])");
+        REQUIRE(diffed(R"([{"a":1,"b":2},3])", R"([{"a":1,"b":5},3])") ==
+                R"([{"op":"replace","path":"\/0\/b","value":5}])");
+        REQUIRE(diffed("[1,2,3]", "[]") == R"([{"op":"remove","path":"\/0"},{"op":"remove","path":"\/0"},{"op":"remove","path":"\/0"}])");
+        REQUIRE(diffed("[]", "[1,2]") == R"([{"op":"add","path":"\/0","value":1},{"op":"add","path":"\/1","value":2}])");
+        diffed("[1,2,3,4,5,6]", "[6,5,4,3,2,1]");
+        diffed("[1,[2,3],4,[5],6]", "[[5],7,[2,4],1,6,6]");
+    }
+
+    SECTION("generated") {
+        // mutate a document and check the diff reproduces the mutation
+        unsigned seed = 42;
+        auto next = [&seed](unsigned limit) {
+            seed = seed * 1103515245u + 12345u;
+            return (seed >> 16) % limit;
+        };
+
+        for(int round = 0; round < 200; ++round) {
+            json::array lhs;
+            for(unsigned i = 0, n = next(12); i < n; ++i) {
+                lhs.push_back(json::object{ { "id", static_cast<double>(next(6)) }, { "tags", json::array{ 1.0, static_cast<double>(next(3)) } } });
+            }
+
+            json::array rhs = lhs;
+            for(unsigned i = 0, n = next(4); i < n; ++i) {
+                auto kind = next(3);
+                if(kind == 0 || rhs.empty()) {
+                    rhs.insert(rhs.begin() + next(static_cast<unsigned>(rhs.size()) + 1), static_cast<double>(next(10)));
+                }
+                else if(kind == 1) {
+                    rhs.erase(rhs.begin() + next(static_cast<unsigned>(rhs.size())));
+                }
+                else {
+                    rhs[next(static_cast<unsigned>(rhs.size()))] = json::object{ { "id", static_cast<double>(next(6)) } };
+                }
+            }
+
+            json::value result = lhs;
+            json::value target = rhs;
+            json::apply_patch(result, json::diff(result, target));
+            REQUIRE(result == target);
+        }
+    }
+}
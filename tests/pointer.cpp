@@ -0,0 +1,107 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <catch.hpp>
+#include <jsonpp/parser.hpp>
+#include <jsonpp/pointer.hpp>
+#include <fstream>
+
+TEST_CASE("json pointer", "[pointer]") {
+    json::value v;
+    REQUIRE_NOTHROW(json::parse(R"({
+        "foo": ["bar", "baz"],
+        "": 0,
+        "a/b": 1,
+        "c%d": 2,
+        "e^f": 3,
+        "g|h": 4,
+        "i\\j": 5,
+        "k\"l": 6,
+        " ": 7,
+        "m~n": 8,
+        "10": { "0": 9 }
+    })", v));
+
+    SECTION("RFC 6901 examples") {
+        REQUIRE(json::pointer("").resolve(v) == &v);
+        REQUIRE(json::pointer("/foo").resolve(v) == v.find("foo"));
+        REQUIRE(json::pointer("/foo/0").resolve(v)->get<std::string>() == "bar");
+        REQUIRE(json::pointer("/").resolve(v)->as<int>() == 0);
+        REQUIRE(json::pointer("/a~1b").resolve(v)->as<int>() == 1);
+        REQUIRE(json::pointer("/c%d").resolve(v)->as<int>() == 2);
+        REQUIRE(json::pointer("/e^f").resolve(v)->as<int>() == 3);
+        REQUIRE(json::pointer("/g|h").resolve(v)->as<int>() == 4);
+        REQUIRE(json::pointer("/i\\j").resolve(v)->as<int>() == 5);
+        REQUIRE(json::pointer("/k\"l").resolve(v)->as<int>() == 6);
+        REQUIRE(json::pointer("/ ").resolve(v)->as<int>() == 7);
+        REQUIRE(json::pointer("/m~0n").resolve(v)->as<int>() == 8);
+        REQUIRE(json::pointer("/10/0").resolve(v)->as<int>() == 9);
+    }
+
+    SECTION("missing paths") {
+        REQUIRE(json::pointer("/foo/2").resolve(v) == nullptr);
+        REQUIRE(json::pointer("/foo/01").resolve(v) == nullptr);
+        REQUIRE(json::pointer("/foo/-").resolve(v) == nullptr);
+        REQUIRE(json::pointer("/foo/bar").resolve(v) == nullptr);
+        REQUIRE(json::pointer("/bar").resolve(v) == nullptr);
+        REQUIRE(json::pointer("/a~1b/c").resolve(v) == nullptr);
+    }
+
+    SECTION("mutation through a pointer") {
+        json::pointer p("/foo/1");
+        json::value* elem = p.resolve(v);
+        REQUIRE(elem != nullptr);
+        *elem = 10;
+        REQUIRE(v["foo"][1].as<int>() == 10);
+
+        const json::value& cv = v;
+        REQUIRE(p.resolve(cv) == elem);
+    }
+
+    SECTION("round trip") {
+        json::pointer p("/a~1b/m~0n/0");
+        REQUIRE(p.path().size() == 3);
+        REQUIRE(p.path()[0].key == "a/b");
+        REQUIRE(p.path()[1].key == "m~n");
+        REQUIRE(p.path()[2].index == 0);
+        REQUIRE(p.to_string() == "/a~1b/m~0n/0");
+    }
+
+    SECTION("invalid") {
+        REQUIRE_THROWS(json::pointer("foo"));
+        REQUIRE_THROWS(json::pointer("/foo~"));
+        REQUIRE_THROWS(json::pointer("/foo~2"));
+    }
+}
+
+TEST_CASE("json pointer on twitter response", "[pointer-real]") {
+    json::value v;
+    std::ifstream in("tests/real/twitter.json");
+    REQUIRE(in.is_open());
+    REQUIRE_NOTHROW(json::parse(in, v));
+
+    json::pointer name("/0/user/name");
+    json::pointer url("/0/user/entities/url/urls/0/expanded_url");
+    REQUIRE(name.resolve(v) != nullptr);
+    REQUIRE(name.resolve(v)->get<std::string>() == "OAuth Dancer");
+    REQUIRE(url.resolve(v) != nullptr);
+    REQUIRE(url.resolve(v)->is<json::null>());
+}
@@ -0,0 +1,64 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include <catch.hpp>
+#include <jsonpp.hpp>
+#include <sstream>
+
+// the tests in this directory are built with JSONPP_SEPARATE_COMPILATION and linked against libjsonpp.a
+
+TEST_CASE("separate compilation", "[separate]") {
+    json::value v;
+    json::parse(R"({"a": [1, 2.5, "x\ny"], "b": null})", v);
+    REQUIRE(v.is<json::object>());
+    REQUIRE(v["a"][2].as<std::string>() == "x\ny");
+
+    json::format_options minify(0, json::format_options::minify);
+    const std::string expected = R"({"a":[1,2.5,"x\ny"],"b":null})";
+
+    SECTION("instantiated streams") {
+        std::ostringstream ss;
+        dump(ss, v, minify);
+        REQUIRE(ss.str() == expected);
+
+        std::ostringstream base;
+        std::ostream& out = base;
+        dump(out, v, minify);
+        REQUIRE(base.str() == expected);
+        REQUIRE(json::dump_string(v, minify) == expected);
+    }
+
+    SECTION("other streams are instantiated in place") {
+        std::stringstream ss;
+        dump(ss, v, minify);
+        REQUIRE(ss.str() == expected);
+
+        json::value w;
+        json::parse(ss, w);
+        REQUIRE(w == v);
+    }
+
+    SECTION("errors") {
+        json::value w;
+        REQUIRE_THROWS_AS(json::parse("[1 2]", w), json::parser_error);
+    }
+}
@@ -0,0 +1,46 @@
+#!/usr/bin/env python
+
+# checks that an object file built with JSONPP_SEPARATE_COMPILATION does not contain
+# its own copy of what libjsonpp.a already compiles
+# the object file should be built without optimisations so that nothing is hidden by inlining
+
+import re
+import subprocess
+import sys
+
+# the streams that src/jsonpp.cpp instantiates the dump of a value for
+streams = r'(std::ostream|json::string_sink|std::(__cxx11::)?basic_ostringstream<char, std::char_traits<char>, std::allocator<char> >)'
+
+forbidden = [
+    re.compile(r'json::[\w:]+<' + streams + r' ?[,>]'),
+    re.compile(r'json::parser::parse_value\('),
+    re.compile(r'json::parse\((std::__cxx11::basic_string|std::string)')
+]
+
+# the hidden friend only forwards to value::dump_value
+allowed = re.compile(r'^(.* )?json::dump<' + streams + r' ?>\(.+&, json::value const&, json::format_options\)$')
+
+def symbols(filename):
+    output = subprocess.check_output(['nm', '-C', '--defined-only', filename])
+    for line in output.decode('utf-8').splitlines():
+        parts = line.split(' ', 2)
+        if len(parts) == 3:
+            yield parts[2]
+
+def main():
+    if len(sys.argv) < 2:
+        print('usage: symbols.py <object files...>')
+        return 2
+
+    failed = False
+    for filename in sys.argv[1:]:
+        for symbol in symbols(filename):
+            if allowed.match(symbol):
+                continue
+            if any(pattern.search(symbol) for pattern in forbidden):
+                print('{}: compiled outside the library: {}'.format(filename, symbol))
+                failed = True
+    return 1 if failed else 0
+
+if __name__ == '__main__':
+    sys.exit(main())
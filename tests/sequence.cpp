@@ -0,0 +1,154 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include <catch.hpp>
+#include <jsonpp/sequence.hpp>
+#include <sstream>
+#include <vector>
+
+namespace {
+std::vector<json::value> collect(json::sequence& seq) {
+    std::vector<json::value> result;
+    for(auto&& v : seq) {
+        result.push_back(std::move(v));
+    }
+    return result;
+}
+} // anonymous namespace
+
+TEST_CASE("concatenated values", "[sequence]") {
+    SECTION("white space and nothing in between") {
+        json::sequence seq(R"({"a": 1}
+[1, 2]  "text"{"b":null}true 10
+)");
+        auto values = collect(seq);
+        REQUIRE(values.size() == 6u);
+        REQUIRE(values[0]["a"].as<int>() == 1);
+        REQUIRE(values[1].is<json::array>());
+        REQUIRE(values[2].as<std::string>() == "text");
+        REQUIRE(values[3]["b"].is<json::null>());
+        REQUIRE(values[4].as<bool>());
+        REQUIRE(values[5].as<int>() == 10);
+    }
+
+    SECTION("record separators") {
+        json::sequence seq(std::string("\x1E{\"id\": 1}\n\x1E{\"id\": 2}\n\x1E\x1E 3\n"));
+        auto values = collect(seq);
+        REQUIRE(values.size() == 3u);
+        REQUIRE(values[0]["id"].as<int>() == 1);
+        REQUIRE(values[1]["id"].as<int>() == 2);
+        REQUIRE(values[2].as<int>() == 3);
+    }
+
+    SECTION("empty") {
+        json::sequence empty("");
+        REQUIRE(empty.begin() == empty.end());
+        json::sequence blank(" \n\x1E\t");
+        REQUIRE(blank.begin() == blank.end());
+    }
+
+    SECTION("streams") {
+        std::istringstream in("1\n2\n3\n");
+        json::sequence seq(in);
+        int expected = 1;
+        for(auto&& v : seq) {
+            REQUIRE(v.as<int>() == expected++);
+        }
+        REQUIRE(expected == 4);
+    }
+
+    SECTION("streams are read one value at a time") {
+        std::istringstream in("{\"a\": [1, \"]\\\"}\"]}\n[2]\"x\" 30\x1E true");
+        json::sequence seq(in);
+        auto it = seq.begin();
+        REQUIRE((*it)["a"][1].as<std::string>() == "]\"}");
+        REQUIRE(in.tellg() == 18);
+        ++it;
+        REQUIRE((*it)[0].as<int>() == 2);
+        REQUIRE(in.tellg() == 22);
+        ++it;
+        REQUIRE(it->as<std::string>() == "x");
+        ++it;
+        REQUIRE(it->as<int>() == 30);
+        REQUIRE(in.tellg() == 28);
+        ++it;
+        REQUIRE(it->as<bool>());
+        ++it;
+        REQUIRE(it == seq.end());
+    }
+
+    SECTION("stream errors report the position in the whole stream") {
+        std::istringstream in("{}\n[1] [1 2]\n");
+        json::sequence seq(in);
+        auto it = seq.begin();
+        ++it;
+        try {
+            ++it;
+            FAIL("expected parser_error");
+        }
+        catch(const json::parser_error& e) {
+            REQUIRE(std::string(e.what()).find("stdin:2:") == 0);
+        }
+    }
+
+    SECTION("single pass") {
+        json::sequence seq("1 2");
+        auto it = seq.begin();
+        REQUIRE(it->as<int>() == 1);
+        ++it;
+        REQUIRE(seq.begin()->as<int>() == 2);
+        ++it;
+        REQUIRE(it == seq.end());
+    }
+
+    SECTION("errors report the position in the whole buffer") {
+        json::sequence seq("{}\n[1]\n[1 2]\n");
+        auto it = seq.begin();
+        ++it;
+        try {
+            ++it;
+            FAIL("expected parser_error");
+        }
+        catch(const json::parser_error& e) {
+            REQUIRE(std::string(e.what()).find("stdin:3:") == 0);
+        }
+    }
+
+    SECTION("values are checked") {
+        json::sequence seq("[1] x");
+        auto it = seq.begin();
+        REQUIRE_THROWS_AS(++it, json::parser_error);
+    }
+}
+
+TEST_CASE("parser::next", "[sequence]") {
+    json::parser p("1 [true] {}", json::parse_options::lazy_numbers);
+    json::value v;
+    REQUIRE(p.next(v));
+    REQUIRE(v.as<int>() == 1);
+    REQUIRE(p.next(v));
+    REQUIRE(v.is<json::array>());
+    REQUIRE(p.next(v));
+    REQUIRE(v.is<json::object>());
+    REQUIRE_FALSE(p.next(v));
+    REQUIRE_FALSE(p.next(v));
+}
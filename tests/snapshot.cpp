@@ -0,0 +1,103 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <catch.hpp>
+#include <jsonpp/snapshot.hpp>
+#include <jsonpp/parser.hpp>
+#include <fstream>
+#include <sstream>
+
+namespace {
+std::string text(const json::value& v) {
+    return json::dump_string(v, json::format_options(0, json::format_options::minify));
+}
+} // anonymous namespace
+
+TEST_CASE("snapshots", "[snapshot]") {
+    json::value v;
+    json::parse(R"({"name": "jsonpp", "version": 1.5, "tags": ["a", "bc", ""], "nested": {"ok": true, "none": null},)"
+                R"( "big": 9007199254740993, "b": 1, "ba": 2, "": 3})", v, json::parse_options::lazy_numbers);
+    auto data = json::snapshot::dump_string(v);
+    json::snapshot_view root(data);
+
+    SECTION("accessors") {
+        REQUIRE(root.is<json::object>());
+        REQUIRE(root.type_name() == "object");
+        REQUIRE(root.size() == 8);
+        REQUIRE(root["name"].as<std::string>() == "jsonpp");
+        REQUIRE(std::string(root["name"].as<const char*>()) == "jsonpp");
+        REQUIRE(root["version"].as<double>() == 1.5);
+        REQUIRE(root["big"].as<long long>() == 9007199254740993LL);
+        REQUIRE(root["tags"].is<json::array>());
+        REQUIRE(root["tags"].size() == 3);
+        REQUIRE(root["tags"][1].as<std::string>() == "bc");
+        REQUIRE(root["tags"][2].as<std::string>().empty());
+        REQUIRE(root["tags"][3].is<json::null>());
+        REQUIRE(root["nested"]["ok"].as<bool>());
+        REQUIRE(root["nested"]["none"].is<json::null>());
+        REQUIRE(root["b"].as<int>() == 1);
+        REQUIRE(root["ba"].as<int>() == 2);
+        REQUIRE(root[""].as<int>() == 3);
+        REQUIRE(root.contains("nested"));
+        REQUIRE(!root.contains("bb"));
+        REQUIRE(root["missing"]["deeper"].is<json::null>());
+        REQUIRE(root["name"].as<int>(10) == 10);
+        REQUIRE(std::string(root.key(0)).empty());
+        REQUIRE(root.member(0).as<int>() == 3);
+    }
+
+    SECTION("round trip") {
+        REQUIRE(text(root.to_value()) == text(v));
+
+        std::ostringstream ss;
+        json::snapshot::dump(ss, v);
+        REQUIRE(ss.str() == data);
+    }
+
+    SECTION("invalid") {
+        REQUIRE_THROWS_AS(json::snapshot_view(std::string("jsonpp")), std::invalid_argument);
+        REQUIRE_THROWS_AS(json::snapshot_view(std::string(32, 'x')), std::invalid_argument);
+    }
+
+    SECTION("truncated") {
+        for(std::size_t length : { std::size_t(32), std::size_t(40), data.size() / 2, data.size() - 8, data.size() - 1 }) {
+            INFO("cut at " << length << " of " << data.size());
+            std::string cut = data.substr(0, length);
+            REQUIRE_THROWS_AS(json::snapshot_view(cut.data(), cut.size()), std::invalid_argument);
+        }
+
+        std::string cut = data;
+        cut[20] = 'x'; // the size of the root object
+        REQUIRE_THROWS_AS(json::snapshot_view(cut), std::invalid_argument);
+    }
+
+    SECTION("real data") {
+        std::ifstream in("tests/real/twitter.json");
+        REQUIRE(in.is_open());
+        json::value twitter;
+        json::parse(in, twitter);
+        auto snapshot = json::snapshot::dump_string(twitter);
+        json::snapshot_view view(snapshot);
+        REQUIRE(text(view.to_value()) == text(twitter));
+        REQUIRE(view[0]["user"]["name"].as<std::string>() == "OAuth Dancer");
+        REQUIRE(view[0]["id"].as<unsigned long long>() == 240558470661799936);
+    }
+}
@@ -0,0 +1,109 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include <catch.hpp>
+#include <jsonpp/parser.hpp>
+
+// the tests in this directory are built into their own executable with JSONPP_STATS
+// since a program must not mix translation units built with and without it
+
+TEST_CASE("parse and dump statistics", "[stats]") {
+    const std::string text = R"({"a\"b": [1, 2.5, "x\ny", {"deep": [null, true]}], "plain": "text"})";
+
+    SECTION("parsing") {
+        json::stats parsing;
+        json::value v;
+        {
+            json::stats_scope scope(&parsing);
+            json::parse(text, v);
+        }
+
+        REQUIRE(parsing.bytes == text.size());
+        REQUIRE(parsing.nulls == 1);
+        REQUIRE(parsing.booleans == 1);
+        REQUIRE(parsing.numbers == 2);
+        REQUIRE(parsing.strings == 2);
+        REQUIRE(parsing.keys == 3);
+        REQUIRE(parsing.arrays == 2);
+        REQUIRE(parsing.objects == 2);
+        REQUIRE(parsing.values() == 10);
+        REQUIRE(parsing.escaped_strings == 2);
+        REQUIRE(parsing.max_depth == 4);
+        REQUIRE(parsing.total_time.count() > 0);
+        REQUIRE(parsing.total_time >= parsing.string_time + parsing.number_time);
+
+        // nothing is collected outside of a scope
+        json::parse(text, v);
+        REQUIRE(parsing.bytes == text.size());
+
+        // a failed parse keeps what it saw
+        json::stats failed;
+        json::stats_scope scope(&failed);
+        REQUIRE_THROWS(json::parse("[1, 2, x]", v));
+        REQUIRE(failed.numbers == 2);
+        REQUIRE(failed.bytes == 0);
+    }
+
+    SECTION("dumping") {
+        json::value v;
+        json::parse(text, v);
+
+        json::stats dumping;
+        std::string result;
+        {
+            json::stats_scope scope(nullptr, &dumping);
+            result = json::dump_string(v);
+        }
+
+        REQUIRE(dumping.bytes == result.size());
+        REQUIRE(dumping.values() == 10);
+        REQUIRE(dumping.keys == 3);
+        REQUIRE(dumping.escaped_strings == 2);
+        REQUIRE(dumping.max_depth == 4);
+    }
+
+    SECTION("scopes nest") {
+        json::stats outer;
+        json::stats inner;
+        json::value v;
+        json::stats_scope first(&outer);
+        {
+            json::stats_scope second(&inner);
+            json::parse("[1]", v);
+        }
+        json::parse("[1, 2]", v);
+        REQUIRE(inner.numbers == 1);
+        REQUIRE(outer.numbers == 2);
+    }
+
+    SECTION("allocations") {
+        json::stats parsing;
+        json::stats_scope scope(&parsing);
+        std::string copy = text;
+        REQUIRE(parsing.allocations == 0);
+
+        json::value v;
+        json::parse(copy, v);
+        REQUIRE(parsing.allocations > 0);
+        REQUIRE(parsing.allocated_bytes >= parsing.allocations);
+    }
+}
@@ -0,0 +1,117 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <catch.hpp>
+#include <jsonpp/value.hpp>
+#include <jsonpp/writer.hpp>
+#include <sstream>
+#include <vector>
+
+namespace {
+template<typename OStream>
+void write_document(json::writer<OStream>& w) {
+    w.begin_object()
+        .key("name").value("rows")
+        .key("empty").begin_array().end_array()
+        .key("nothing").begin_object().end_object()
+        .key("rows").begin_array();
+
+    for(int i = 0; i < 3; ++i) {
+        w.begin_object()
+            .key("id").value(i)
+            .key("ratio").value(i / 4.0)
+            .key("ok").value(i % 2 == 0)
+            .key("tags").begin_array().value("a").value(nullptr).end_array()
+         .end_object();
+    }
+
+    w.end_array()
+     .key("nested").value(json::value{ 1, "two", json::object{ { "three", 3 } } })
+    .end_object();
+}
+
+json::value expected_document() {
+    json::array rows;
+    for(int i = 0; i < 3; ++i) {
+        rows.push_back(json::object{
+            { "id", i },
+            { "ratio", i / 4.0 },
+            { "ok", i % 2 == 0 },
+            { "tags", json::array{ "a", nullptr } }
+        });
+    }
+
+    return json::object{
+        { "name", "rows" },
+        { "empty", json::array{} },
+        { "nothing", json::object{} },
+        { "rows", rows },
+        { "nested", json::value{ 1, "two", json::object{ { "three", 3 } } } }
+    };
+}
+} // anonymous namespace
+
+TEST_CASE("streaming writer", "[writer]") {
+    SECTION("matches dump for a single value") {
+        json::string_sink out;
+        auto w = json::make_writer(out);
+        w.value(json::value{ 1, 2, 3 });
+        REQUIRE(w.complete());
+        REQUIRE(out.str() == json::dump_string(json::value{ 1, 2, 3 }));
+    }
+
+    // json::object sorts its keys so the members are written in the same order
+    SECTION("matches dump when members are sorted") {
+        for(auto&& opt : { json::format_options(), json::format_options(2), json::format_options(0, json::format_options::minify) }) {
+            json::string_sink out;
+            json::writer<json::string_sink> w(out, opt);
+            w.begin_object();
+            auto&& doc = expected_document();
+            for(auto&& member : doc.get<json::object>()) {
+                w.key(member.first).value(member.second);
+            }
+            w.end_object();
+            REQUIRE(w.complete());
+            REQUIRE(out.str() == json::dump_string(doc, opt));
+        }
+    }
+
+    SECTION("incremental output") {
+        json::format_options minify(0, json::format_options::minify);
+        std::ostringstream ss;
+        auto w = json::make_writer(ss, minify);
+        write_document(w);
+        REQUIRE(w.complete());
+        REQUIRE(w.depth() == 0);
+        REQUIRE(ss.str() == "{\"name\":\"rows\",\"empty\":[],\"nothing\":{},\"rows\":["
+                            "{\"id\":0,\"ratio\":0,\"ok\":true,\"tags\":[\"a\",null]},"
+                            "{\"id\":1,\"ratio\":0.25,\"ok\":false,\"tags\":[\"a\",null]},"
+                            "{\"id\":2,\"ratio\":0.5,\"ok\":true,\"tags\":[\"a\",null]}],"
+                            "\"nested\":[1,\"two\",{\"three\":3}]}");
+    }
+
+    SECTION("pretty output") {
+        json::string_sink out;
+        auto w = json::make_writer(out, json::format_options(2));
+        w.begin_array().value(1).begin_object().key("a").begin_array().end_array().end_object().end_array();
+        REQUIRE(out.str() == "[\n  1,\n  {\n    \"a\": []\n  }\n]");
+    }
+}
@@ -0,0 +1,164 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2014 Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+// writes a synthetic JSON document, see json::generator_options for what each option controls
+//
+// usage: generate [--seed <n>] [--depth <n>] [--width <n>] [--length <n>] [--containers <ratio>]
+//                 [--strings <ratio>] [--string-length <n>] [--escapes <ratio>]
+//                 [--numbers small|large|decimal|exponent|mixed] [--size <n>[k|m|g]] [--output <file>]
+
+#include <jsonpp/generator.hpp>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace {
+// buffers writes to a C stream since the generator emits a few bytes at a time
+class file_sink {
+private:
+    std::FILE* file;
+    std::string buffer;
+
+    void flush_if_full() {
+        if(buffer.size() >= 1 << 16) {
+            flush();
+        }
+    }
+public:
+    explicit file_sink(std::FILE* file): file(file) {
+        buffer.reserve((1 << 16) + 64);
+    }
+
+    void put(char ch) {
+        buffer.push_back(ch);
+        flush_if_full();
+    }
+
+    void write(const char* str, std::size_t size) {
+        buffer.append(str, size);
+        flush_if_full();
+    }
+
+    void flush() {
+        std::fwrite(buffer.data(), 1, buffer.size(), file);
+        buffer.clear();
+    }
+};
+
+int usage(const char* name) {
+    std::fprintf(stderr, "usage: %s [--seed <n>] [--depth <n>] [--width <n>] [--length <n>] [--containers <ratio>]\n"
+                         "       [--strings <ratio>] [--string-length <n>] [--escapes <ratio>]\n"
+                         "       [--numbers small|large|decimal|exponent|mixed] [--size <n>[k|m|g]] [--output <file>]\n", name);
+    return EXIT_FAILURE;
+}
+
+std::uint64_t parse_size(const char* str) {
+    static const char suffixes[] = "kmg";
+    char* last = nullptr;
+    auto result = std::strtoull(str, &last, 10);
+    auto suffix = std::strchr(suffixes, std::tolower(*last));
+    if(*last != '\0' && suffix != nullptr) {
+        result <<= 10 * (suffix - suffixes + 1);
+    }
+    return result;
+}
+
+bool parse_numbers(const std::string& str, json::generator_options::number_distribution& numbers) {
+    static const char* const names[] = { "small", "large", "decimal", "exponent", "mixed" };
+    for(int i = 0; i <= json::generator_options::mixed; ++i) {
+        if(str == names[i]) {
+            numbers = static_cast<json::generator_options::number_distribution>(i);
+            return true;
+        }
+    }
+    return false;
+}
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    json::generator_options opt;
+    const char* output = nullptr;
+    for(int i = 1; i < argc; ++i) {
+        if(i + 1 >= argc) {
+            return usage(argv[0]);
+        }
+
+        std::string arg = argv[i];
+        const char* next = argv[++i];
+        if(arg == "--seed") {
+            opt.seed = std::strtoull(next, nullptr, 10);
+        }
+        else if(arg == "--depth") {
+            opt.depth = static_cast<unsigned>(std::atoi(next));
+        }
+        else if(arg == "--width") {
+            opt.width = static_cast<unsigned>(std::atoi(next));
+        }
+        else if(arg == "--length") {
+            opt.length = static_cast<unsigned>(std::atoi(next));
+        }
+        else if(arg == "--containers") {
+            opt.container_ratio = std::atof(next);
+        }
+        else if(arg == "--strings") {
+            opt.string_ratio = std::atof(next);
+        }
+        else if(arg == "--string-length") {
+            opt.string_length = static_cast<unsigned>(std::atoi(next));
+        }
+        else if(arg == "--escapes") {
+            opt.escape_ratio = std::atof(next);
+        }
+        else if(arg == "--numbers") {
+            if(!parse_numbers(next, opt.numbers)) {
+                return usage(argv[0]);
+            }
+        }
+        else if(arg == "--size") {
+            opt.size = parse_size(next);
+        }
+        else if(arg == "--output") {
+            output = next;
+        }
+        else {
+            return usage(argv[0]);
+        }
+    }
+
+    std::FILE* file = output != nullptr ? std::fopen(output, "wb") : stdout;
+    if(file == nullptr) {
+        std::perror(output);
+        return EXIT_FAILURE;
+    }
+
+    file_sink out(file);
+    json::generate(out, opt);
+    out.put('\n');
+    out.flush();
+    bool failed = std::ferror(file) != 0;
+    if(output != nullptr) {
+        failed = std::fclose(file) != 0 || failed;
+    }
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}